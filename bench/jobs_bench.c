@@ -0,0 +1,194 @@
+// Job system benchmark: scaling of a shot search (parallel-for) and of a level batch (jobs with children
+// and dependencies) from 1 thread to every core. Usage: jobs_bench [max threads]
+#define _POSIX_C_SOURCE 199309L
+
+#include "collision.h"
+#include "jobs.h"
+#include "level.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_RUNS                        3        // Best of
+#define SEARCH_MAX_ANGLE                 90
+#define SEARCH_MAX_POWER                300
+#define SEARCH_GRAIN                     16        // Shots per range
+#define BATCH_GROUPS                     64        // Jobs with children
+#define BATCH_LEVELS                     64        // Levels generated by each group
+
+typedef struct ShotSearch {
+    CollisionWorld world;
+    Vector2 position;
+    int hits[SEARCH_MAX_ANGLE*SEARCH_MAX_POWER];
+} ShotSearch;
+
+typedef struct LevelGroup {
+    Job job;
+    Job child[BATCH_LEVELS];
+    Level level[BATCH_LEVELS];
+    unsigned int seed;
+} LevelGroup;
+
+static ShotSearch search = { 0 };
+static LevelGroup group[BATCH_GROUPS] = { 0 };
+static unsigned int batchChecksum = 0;
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+// Same speed as FireProjectile(), for the left player
+static void SearchShots(void *data, int start, int end)
+{
+    ShotSearch *search = (ShotSearch *)data;
+
+    for (int i = start; i < end; i++)
+    {
+        int angle = i/SEARCH_MAX_POWER + 1;
+        int power = i%SEARCH_MAX_POWER + 1;
+        Vector2 speed = { cosf(angle*DEG2RAD)*power*3/DELTA_FPS, -sinf(angle*DEG2RAD)*power*3/DELTA_FPS };
+        float tick = 0.0f;
+
+        Impact impact = SimulateShot(&search->world, search->position, speed, 10, 0, 1, 100000, &tick);
+        search->hits[i] = (impact.type == IMPACT_PLAYER);
+    }
+}
+
+static void GenerateGroupLevel(void *data)
+{
+    Level *level = (Level *)data;
+    GenerateLevel(level, level->seed, 800, 450);
+}
+
+// Group job: one child job per level, the group is done once every child is done
+static void GenerateGroup(void *data)
+{
+    LevelGroup *group = (LevelGroup *)data;
+
+    for (int i = 0; i < BATCH_LEVELS; i++)
+    {
+        group->level[i].seed = group->seed + i;
+        InitJob(&group->child[i], GenerateGroupLevel, &group->level[i], &group->job);
+        SubmitJob(&group->child[i]);
+    }
+}
+
+// Runs after every group, through its dependencies
+static void SumBatch(void *data)
+{
+    (void)data;
+    batchChecksum = 0;
+
+    for (int g = 0; g < BATCH_GROUPS; g++)
+    {
+        for (int i = 0; i < BATCH_LEVELS; i++) batchChecksum += (unsigned int)group[g].level[i].playerPosition[1].x;
+    }
+}
+
+static double RunShotSearch(int *hits)
+{
+    double start = GetMilliseconds();
+
+    ParallelFor(SEARCH_MAX_ANGLE*SEARCH_MAX_POWER, SEARCH_GRAIN, SearchShots, &search);
+
+    double elapsed = GetMilliseconds() - start;
+
+    *hits = 0;
+    for (int i = 0; i < SEARCH_MAX_ANGLE*SEARCH_MAX_POWER; i++) *hits += search.hits[i];
+
+    return elapsed;
+}
+
+static double RunLevelBatch(void)
+{
+    Job sum;
+
+    double start = GetMilliseconds();
+
+    InitJob(&sum, SumBatch, NULL, NULL);
+
+    for (int g = 0; g < BATCH_GROUPS; g++)
+    {
+        group[g].seed = 1000u + g*BATCH_LEVELS;
+        InitJob(&group[g].job, GenerateGroup, &group[g], NULL);
+
+        if (!AddJobDependency(&sum, &group[g].job))
+        {
+            fprintf(stderr, "group %d: too many continuations\n", g);
+            exit(1);
+        }
+    }
+
+    SubmitJob(&sum);
+    for (int g = 0; g < BATCH_GROUPS; g++) SubmitJob(&group[g].job);
+
+    WaitJob(&sum);
+
+    return GetMilliseconds() - start;
+}
+
+int main(int argc, char *argv[])
+{
+    int maxThreads = (argc > 1)? atoi(argv[1]) : GetCpuCount();
+    if (maxThreads < 1) maxThreads = 1;
+    if (maxThreads > MAX_JOB_WORKERS + 1) maxThreads = MAX_JOB_WORKERS + 1;
+
+    Level level = { 0 };
+    GenerateLevel(&level, 12345u, 800, 450);
+
+    static Player player[MAX_PLAYERS] = { 0 };
+    static Explosion explosion[MAX_EXPLOSIONS] = { 0 };
+
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        player[i].position = level.playerPosition[i];
+        player[i].size = (Vector2){ PLAYER_SIZE, PLAYER_SIZE };
+        player[i].isAlive = true;
+    }
+
+    search.world = (CollisionWorld){ level.building, level.buildingCount, explosion, MAX_EXPLOSIONS, player, MAX_PLAYERS, 800, 450 };
+    search.position = player[0].position;
+
+    printf("%d cores, %d shots per search, %d levels per batch\n\n", GetCpuCount(), SEARCH_MAX_ANGLE*SEARCH_MAX_POWER, BATCH_GROUPS*BATCH_LEVELS);
+    printf("%8s %12s %9s %6s %12s %9s %10s\n", "threads", "search ms", "speedup", "hits", "batch ms", "speedup", "checksum");
+
+    double searchBase = 0.0;
+    double batchBase = 0.0;
+
+    for (int threads = 1; threads <= maxThreads; threads++)
+    {
+        // The calling thread runs jobs while it waits, it counts as one of the threads
+        InitJobSystem(threads - 1, false);
+
+        double searchBest = 0.0;
+        double batchBest = 0.0;
+        int hits = 0;
+
+        for (int r = 0; r < BENCH_RUNS; r++)
+        {
+            double searchTime = RunShotSearch(&hits);
+            double batchTime = RunLevelBatch();
+
+            if ((r == 0) || (searchTime < searchBest)) searchBest = searchTime;
+            if ((r == 0) || (batchTime < batchBest)) batchBest = batchTime;
+        }
+
+        CloseJobSystem();
+
+        if (threads == 1)
+        {
+            searchBase = searchBest;
+            batchBase = batchBest;
+        }
+
+        printf("%8d %12.2f %8.2fx %6d %12.2f %8.2fx %10u\n", threads, searchBest, searchBase/searchBest, hits, batchBest, batchBase/batchBest, batchChecksum);
+    }
+
+    return 0;
+}
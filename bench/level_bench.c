@@ -0,0 +1,82 @@
+// Level queue benchmark: time spent in GetNextLevel() by a restart, with plain and fair levels.
+// Restarts are spaced like real matches, a queue refilled in the background makes every one of them a copy,
+// also without job workers. Usage: level_bench [workers] [restarts]
+#define _POSIX_C_SOURCE 199309L
+
+#include "fairness.h"
+#include "jobs.h"
+#include "level.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DEFAULT_RESTARTS                 20
+#define MATCH_TIME_MS                   250        // Between two restarts, the queue has that long to refill
+#define SLOW_RESTART_MS               1.00f        // Longer than that is a frame lost
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+static void SleepMilliseconds(int milliseconds)
+{
+    struct timespec time = { milliseconds/1000, (milliseconds%1000)*1000000L };
+    nanosleep(&time, NULL);
+}
+
+static void RunRestarts(const char *name, LevelGenerator generator, int restarts)
+{
+    static Level level;
+    double total = 0.0;
+    double longest = 0.0;
+    int slow = 0;
+
+    SetLevelGenerator(generator);
+    InitLevelQueue(1234u, 800, 450);
+
+    // The first match starts once the queue had time to fill, like the game after loading its resources
+    SleepMilliseconds(LEVEL_QUEUE_SIZE*MATCH_TIME_MS);
+
+    for (int i = 0; i < restarts; i++)
+    {
+        double start = GetMilliseconds();
+        GetNextLevel(&level);
+        double elapsed = GetMilliseconds() - start;
+
+        total += elapsed;
+        if (elapsed > longest) longest = elapsed;
+        if (elapsed > SLOW_RESTART_MS) slow++;
+
+        SleepMilliseconds(MATCH_TIME_MS);
+    }
+
+    CloseLevelQueue();
+
+    printf("%-8s %10.3f %10.3f %8d/%d\n", name, total/restarts, longest, slow, restarts);
+}
+
+int main(int argc, char *argv[])
+{
+    int workers = (argc > 1)? atoi(argv[1]) : 0;
+    int restarts = (argc > 2)? atoi(argv[2]) : DEFAULT_RESTARTS;
+    if (restarts < 1) restarts = 1;
+
+    InitJobSystem(workers, false);
+    SetLevelFairness(FAIRNESS_DEFAULT_THRESHOLD, FAIRNESS_DEFAULT_BUDGET);
+    SetTraceLogLevel(LOG_WARNING + 1);
+
+    printf("%d job workers, %d restarts every %d ms\n\n", GetJobWorkerCount(), restarts, MATCH_TIME_MS);
+    printf("%-8s %10s %10s %10s\n", "levels", "avg ms", "max ms", "slow");
+
+    RunRestarts("plain", GenerateLevel, restarts);
+    RunRestarts("fair", GenerateFairLevel, restarts);
+
+    CloseJobSystem();
+
+    return 0;
+}
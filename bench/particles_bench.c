@@ -0,0 +1,89 @@
+// Particle benchmark: time per frame of UpdateParticles() and of the draw for growing particle counts.
+// The draw is the vertex fill of DrawParticles() from the pool arrays, with --window the whole draw (fill, buffer update
+// and draw call) into a hidden window. Usage: particles_bench [--window]
+#define _POSIX_C_SOURCE 199309L
+
+#include "particles.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_FRAMES                    600
+#define FRAME_BUDGET_MS              16.6
+
+static ParticlePool pool;
+static float vertices[MAX_PARTICLES*PARTICLE_VERTICES*3];
+static unsigned char colors[MAX_PARTICLES*PARTICLE_VERTICES*4];
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+int main(int argc, char *argv[])
+{
+    const int counts[] = { 1000, 10000, 30000, 65536 };
+    bool window = ((argc > 1) && (strcmp(argv[1], "--window") == 0));
+
+    if (window)
+    {
+        SetConfigFlags(FLAG_WINDOW_HIDDEN);
+        SetTraceLogLevel(LOG_WARNING);
+        InitWindow(800, 450, "particles bench");
+        LoadParticleMesh();
+    }
+
+    printf("%10s %14s %14s %14s %14s %10s\n", "particles", "update ms", "update max", window? "draw ms" : "fill ms", window? "draw max" : "fill max", "budget %");
+
+    for (int c = 0; c < (int)(sizeof(counts)/sizeof(counts[0])); c++)
+    {
+        double updateTotal = 0.0;
+        double updateWorst = 0.0;
+        double drawTotal = 0.0;
+        double drawWorst = 0.0;
+
+        // NOTE: Lifetime longer than the run so the particle count stays constant
+        InitParticlePool(&pool, 1000.0f, 588.6f, 0.5f, 3, DARKGRAY);
+        EmitParticles(&pool, (Vector2){ 400, 225 }, counts[c], 300.0f);
+
+        for (int f = 0; f < BENCH_FRAMES; f++)
+        {
+            double start = GetMilliseconds();
+            UpdateParticles(&pool, 1.0f/60);
+            double update = GetMilliseconds() - start;
+
+            if (window)
+            {
+                BeginDrawing();
+                ClearBackground(SKYBLUE);
+            }
+
+            start = GetMilliseconds();
+            if (window) DrawParticles((const ParticlePool *[]){ &pool }, 1);
+            else GetParticleVertices(&pool, vertices, colors);
+            double draw = GetMilliseconds() - start;
+
+            if (window) EndDrawing();
+
+            updateTotal += update;
+            drawTotal += draw;
+            if (update > updateWorst) updateWorst = update;
+            if (draw > drawWorst) drawWorst = draw;
+        }
+
+        printf("%10d %14.4f %14.4f %14.4f %14.4f %9.2f%%\n", pool.count, updateTotal/BENCH_FRAMES, updateWorst, drawTotal/BENCH_FRAMES, drawWorst,
+               100.0*(updateTotal + drawTotal)/BENCH_FRAMES/FRAME_BUDGET_MS);
+    }
+
+    if (window)
+    {
+        UnloadParticleMesh();
+        CloseWindow();
+    }
+
+    return 0;
+}
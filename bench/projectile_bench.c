@@ -0,0 +1,102 @@
+// Projectile benchmark: float against fixed-point integration of a full pool, with a checksum of the fixed-point result.
+// The checksum must be the same on every compiler, flag set and CPU, compare it between builds
+#define _POSIX_C_SOURCE 199309L
+
+#include "projectile.h"
+#include "fixedpoint.h"
+
+#include <stdio.h>
+#include <math.h>
+#include <time.h>
+
+#define BENCH_TICKS                     600
+#define BENCH_ROUNDS                    200
+
+static ProjectilePool pool;
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+// Every slot in use, angles 1..90 and powers 1..300 like aimed shots
+static void FillPool(bool fixedPoint)
+{
+    InitProjectilePool(&pool);
+    pool.fixedPoint = fixedPoint;
+
+    for (int i = 0; i < MAX_PROJECTILES; i++)
+    {
+        int angle = 1 + i%90;
+        int power = 1 + (i*7)%300;
+        Vector2 position = { 100.0f + i%600, 300.0f };
+
+        if (fixedPoint)
+        {
+            int speedX = 0;
+            int speedY = 0;
+
+            GetFixedShotSpeed(angle, power, (i%2) == 0, &speedX, &speedY);
+            SpawnFixedProjectile(&pool, position, speedX, speedY, i%MAX_PLAYERS);
+        }
+        else
+        {
+            Vector2 speed = { cosf(angle*DEG2RAD)*power*3/DELTA_FPS, -sinf(angle*DEG2RAD)*power*3/DELTA_FPS };
+
+            if ((i%2) != 0) speed.x = -speed.x;
+            SpawnProjectile(&pool, position, speed, i%MAX_PLAYERS);
+        }
+    }
+}
+
+static double RunTicks(bool fixedPoint)
+{
+    double best = 0.0;
+
+    for (int r = 0; r < BENCH_ROUNDS; r++)
+    {
+        FillPool(fixedPoint);
+
+        double start = GetMilliseconds();
+
+        for (int t = 0; t < BENCH_TICKS; t++)
+        {
+            if (fixedPoint) MoveFixedProjectiles(&pool, FIXED_GRAVITY);
+            else MoveProjectiles(&pool, GRAVITY/DELTA_FPS);
+        }
+
+        double elapsed = GetMilliseconds() - start;
+        if ((r == 0) || (elapsed < best)) best = elapsed;
+    }
+
+    return best;
+}
+
+int main(void)
+{
+    double floatTime = RunTicks(false);
+    double fixedTime = RunTicks(true);
+
+    // FNV-1a of the final fixed-point state, float mirrors included
+    unsigned int hash = 2166136261u;
+    const unsigned char *bytes[] = {
+        (const unsigned char *)pool.fixedPositionX, (const unsigned char *)pool.fixedPositionY,
+        (const unsigned char *)pool.fixedSpeedY, (const unsigned char *)pool.positionX, (const unsigned char *)pool.positionY
+    };
+
+    for (int a = 0; a < 5; a++)
+    {
+        for (int i = 0; i < MAX_PROJECTILES*4; i++) hash = (hash ^ bytes[a][i])*16777619u;
+    }
+
+    printf("%d projectiles, %d ticks\n", MAX_PROJECTILES, BENCH_TICKS);
+    printf("%12s %14s %14s\n", "mode", "ms/run", "ns/projectile");
+    printf("%12s %14.4f %14.3f\n", "float", floatTime, 1000000.0*floatTime/(BENCH_TICKS*MAX_PROJECTILES));
+    printf("%12s %14.4f %14.3f\n", "fixed-point", fixedTime, 1000000.0*fixedTime/(BENCH_TICKS*MAX_PROJECTILES));
+    printf("fixed-point checksum: %08x\n", hash);
+
+    return 0;
+}
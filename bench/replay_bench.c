@@ -0,0 +1,157 @@
+// Replay benchmark: fixed-point matches played tick by tick through the collision path of the game (terrain clearance,
+// swept collisions, craters carved into the terrain field), with a checksum of every impact.
+// The checksum must be the same for every build of the game, `make replay-check` compares it between optimization levels
+#define _POSIX_C_SOURCE 199309L
+
+#include "fixedpoint.h"
+#include "input.h"
+#include "jobs.h"
+#include "match.h"
+#include "projectile.h"
+#include "terrain.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define REPLAY_MATCHES                  200
+#define REPLAY_WIDTH                    800
+#define REPLAY_HEIGHT                   450
+
+static Level level;
+static Match match;
+static ProjectilePool pool;
+static unsigned int hash = 2166136261u;
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+static void HashBytes(const void *data, size_t size)
+{
+    const unsigned char *bytes = (const unsigned char *)data;
+
+    for (size_t i = 0; i < size; i++) hash = (hash ^ bytes[i])*16777619u;
+}
+
+// One shot, as UpdateProjectiles() and UpdateProjectile() of the game fly it in fixed-point mode. Returns the flight ticks
+static int PlayShot(TerrainField *terrain, int angle, int power)
+{
+    int owner = match.playerTurn;
+    int speedX = 0;
+    int speedY = 0;
+    int ticks = 0;
+
+    GetFixedShotSpeed(angle, power, match.player[owner].isLeftTeam, &speedX, &speedY);
+    SpawnFixedProjectile(&pool, match.player[owner].position, speedX, speedY, owner);
+
+    while (pool.count > 0)
+    {
+        CollisionWorld world = GetMatchWorld(&match);
+        Vector2 start = GetProjectilePosition(&pool, 0);
+        Vector2 end = { start.x + pool.speedX[0], start.y + pool.speedY[0] };
+        float step = sqrtf(pool.speedX[0]*pool.speedX[0] + pool.speedY[0]*pool.speedY[0]);
+        Impact impact = { IMPACT_NONE, 1.0f, end, -1 };
+
+        ticks++;
+
+        if (GetShotClearance(terrain, &world, start, PROJECTILE_RADIUS, owner) > step)
+        {
+            if ((end.x + PROJECTILE_RADIUS < 0) || (end.x - PROJECTILE_RADIUS > world.width) || (end.y - PROJECTILE_RADIUS > world.height)) impact.type = IMPACT_OUT;
+        }
+        else impact = SweepProjectile(&world, start, end, PROJECTILE_RADIUS, owner);
+
+        if ((impact.type == IMPACT_NONE) && (ticks < MATCH_MAX_SHOT_TICKS))
+        {
+            MoveFixedProjectiles(&pool, FIXED_GRAVITY);
+            continue;
+        }
+
+        RemoveProjectile(&pool, 0);
+
+        HashBytes(&impact.type, sizeof(impact.type));
+        HashBytes(&impact.target, sizeof(impact.target));
+        HashBytes(&impact.position, sizeof(impact.position));
+        HashBytes(&ticks, sizeof(ticks));
+
+        if (impact.type == IMPACT_PLAYER) match.player[impact.target].isAlive = false;
+        else if (impact.type == IMPACT_BUILDING)
+        {
+            Explosion *crater = &match.explosion[match.explosionNumber];
+            Explosion recycled = *crater;
+
+            crater->position = (Vector2){ impact.position.x, impact.position.y + PROJECTILE_RADIUS };
+            crater->active = true;
+            match.explosionNumber = (match.explosionNumber + 1)%MAX_EXPLOSIONS;
+
+            if (recycled.active) UpdateTerrainFieldArea(terrain, &world, recycled.position, recycled.radius + TERRAIN_MAX_DISTANCE);
+            AddCraterToTerrainField(terrain, crater->position, crater->radius);
+        }
+    }
+
+    return ticks;
+}
+
+int main(void)
+{
+    TerrainField terrain = { 0 };
+    float *samples = (float *)malloc(GetTerrainSampleCount(REPLAY_WIDTH, REPLAY_HEIGHT)*sizeof(float));
+    int shots = 0;
+    long ticks = 0;
+
+    InitJobSystem(0, false);
+    InitProjectilePool(&pool);
+    pool.fixedPoint = true;
+
+    double start = GetMilliseconds();
+
+    for (int m = 0; m < REPLAY_MATCHES; m++)
+    {
+        unsigned int random = 2654435761u*(m + 1) | 1;
+
+        GenerateLevel(&level, 9000u + m, REPLAY_WIDTH, REPLAY_HEIGHT);
+        InitMatch(&match, &level);
+
+        CollisionWorld world = GetMatchWorld(&match);
+        terrain.distance = samples;
+        BuildTerrainField(&terrain, &world);
+
+        // The turns of PlayMatchShot(), the shot itself is flown tick by tick
+        while (!match.over)
+        {
+            random = random*1664525u + 1013904223u;
+
+            ticks += PlayShot(&terrain, 1 + (random >> 8)%MAX_AIM_ANGLE, 1 + (random >> 20)%MAX_AIM_POWER);
+            shots++;
+
+            bool leftTeamAlive = false;
+            bool rightTeamAlive = false;
+
+            for (int i = 0; i < MAX_PLAYERS; i++)
+            {
+                if (match.player[i].isAlive && match.player[i].isLeftTeam) leftTeamAlive = true;
+                if (match.player[i].isAlive && !match.player[i].isLeftTeam) rightTeamAlive = true;
+            }
+
+            match.turns++;
+
+            if (!leftTeamAlive || !rightTeamAlive || (match.turns >= MATCH_MAX_TURNS)) match.over = true;
+            else match.playerTurn = (match.playerTurn + 1)%MAX_PLAYERS;
+        }
+    }
+
+    double elapsed = GetMilliseconds() - start;
+
+    CloseJobSystem();
+    free(samples);
+
+    printf("%d matches, %d shots, %ld ticks, %.2f ms (%.3f us/tick)\n", REPLAY_MATCHES, shots, ticks, elapsed, 1000.0*elapsed/ticks);
+    printf("replay checksum: %08x\n", hash);
+
+    return 0;
+}
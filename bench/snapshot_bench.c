@@ -0,0 +1,77 @@
+// Snapshot benchmark: file size, save time (with fsync), time a queued save costs the simulation and load time (map, validate, copy out)
+#define _POSIX_C_SOURCE 199309L
+
+#include "snapshot.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BENCH_FILE_NAME     "snapshot_bench.sav"
+#define BENCH_SAVES                      50
+#define BENCH_LOADS                   10000
+
+static GameSnapshot snapshot = { 0 };
+static GameSnapshot restored = { 0 };
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+int main(void)
+{
+    // Worst case content: every explosion and projectile slot in use
+    for (int i = 0; i < MAX_EXPLOSIONS; i++) snapshot.explosion[i] = (Explosion){ { (float)i, (float)i }, 30, true };
+    for (int i = 0; i < MAX_PROJECTILES; i++) SpawnProjectile(&snapshot.projectiles, (Vector2){ (float)i, 0 }, (Vector2){ 1, -1 }, i%MAX_PLAYERS);
+
+    double start = GetMilliseconds();
+    for (int i = 0; i < BENCH_SAVES; i++) SaveSnapshot(BENCH_FILE_NAME, &snapshot);
+    double saveTime = (GetMilliseconds() - start)/BENCH_SAVES;
+
+    // What the game pays per save: queuing, the writer thread saves meanwhile
+    double queueTime = 0.0;
+    double longestQueue = 0.0;
+
+    for (int i = 0; i < BENCH_SAVES; i++)
+    {
+        start = GetMilliseconds();
+        QueueSnapshot(BENCH_FILE_NAME, &snapshot);
+        double elapsed = GetMilliseconds() - start;
+
+        queueTime += elapsed/BENCH_SAVES;
+        if (elapsed > longestQueue) longestQueue = elapsed;
+    }
+
+    CloseSnapshotWriter();
+
+    int failures = 0;
+
+    start = GetMilliseconds();
+    for (int i = 0; i < BENCH_LOADS; i++)
+    {
+        const GameSnapshot *mapped = MapSnapshot(BENCH_FILE_NAME);
+
+        if (mapped == NULL) failures++;
+        else
+        {
+            memcpy(&restored, mapped, sizeof(GameSnapshot));
+            UnmapSnapshot(mapped);
+        }
+    }
+    double loadTime = (GetMilliseconds() - start)/BENCH_LOADS;
+
+    unlink(BENCH_FILE_NAME);
+
+    printf("snapshot size:  %zu bytes\n", sizeof(GameSnapshot));
+    printf("save (fsync):   %.4f ms\n", saveTime);
+    printf("save (queued):  %.4f ms, longest %.4f ms\n", queueTime, longestQueue);
+    printf("load (mapped):  %.4f ms\n", loadTime);
+    printf("load failures:  %d\n", failures);
+
+    return (failures == 0)? 0 : 1;
+}
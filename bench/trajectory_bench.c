@@ -0,0 +1,107 @@
+// Shot solver benchmark: SolveShot(), used by headless matches, against the tick stepper of the game (SimulateShot() with single ticks)
+// on the worlds of headless matches with random shots, craters included. Reports the speed of both, the stepper in coarser swept steps too,
+// and every disagreement: a contact grazing a crater rim or a corner can differ, the stepper sweeps chords between the tick positions.
+// Usage: trajectory_bench [matches]
+#define _POSIX_C_SOURCE 199309L
+
+#include "input.h"
+#include "match.h"
+#include "projectile.h"
+#include "trajectory.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define DEFAULT_MATCHES                 500
+#define SHOT_MAX_POWER                  150        // Random shots, stronger ones mostly leave the field
+#define COARSE_TICKS_PER_STEP             4        // Swept steps of SimulateShot(), positions stay exact
+#define TICK_TOLERANCE                 0.05f        // Same impact if the ticks are that close
+
+static Level level;
+static Match match;
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+int main(int argc, char *argv[])
+{
+    int matches = (argc > 1)? atoi(argv[1]) : DEFAULT_MATCHES;
+    if (matches < 1) matches = 1;
+
+    int shots = 0;
+    int typeMismatches = 0;
+    int targetMismatches = 0;
+    int tickMismatches = 0;
+    float largestTickError = 0.0f;
+    double steppedTime = 0.0;
+    double coarseTime = 0.0;
+    double solvedTime = 0.0;
+
+    for (int m = 0; m < matches; m++)
+    {
+        unsigned int random = 2654435761u*(m + 1) | 1;
+
+        GenerateLevel(&level, 5000u + m, 800, 450);
+        InitMatch(&match, &level);
+
+        while (!match.over)
+        {
+            random = random*1664525u + 1013904223u;
+            int angle = 1 + (random >> 8)%MAX_AIM_ANGLE;
+            int power = 1 + (random >> 20)%SHOT_MAX_POWER;
+
+            const Player *shooter = &match.player[match.playerTurn];
+            CollisionWorld world = GetMatchWorld(&match);
+            Vector2 speed = GetShotSpeed(angle, power, shooter->isLeftTeam);
+            float steppedTick = 0.0f;
+            float solvedTick = 0.0f;
+
+            double start = GetMilliseconds();
+            Impact stepped = SimulateShot(&world, shooter->position, speed, PROJECTILE_RADIUS, match.playerTurn, 1, MATCH_MAX_SHOT_TICKS, &steppedTick);
+            double middle = GetMilliseconds();
+            Impact solved = SolveShot(&world, shooter->position, speed, PROJECTILE_RADIUS, match.playerTurn, &solvedTick);
+            double end = GetMilliseconds();
+            SimulateShot(&world, shooter->position, speed, PROJECTILE_RADIUS, match.playerTurn, COARSE_TICKS_PER_STEP, MATCH_MAX_SHOT_TICKS, NULL);
+            double coarse = GetMilliseconds();
+
+            steppedTime += middle - start;
+            solvedTime += end - middle;
+            coarseTime += coarse - end;
+            shots++;
+
+            if (stepped.type != solved.type)
+            {
+                typeMismatches++;
+                printf("type mismatch: level %u, player %d, angle %d, power %d: stepped %d at tick %.3f, solved %d at tick %.3f\n",
+                       level.seed, match.playerTurn, angle, power, stepped.type, steppedTick, solved.type, solvedTick);
+            }
+            else if (stepped.target != solved.target) targetMismatches++;
+            else if (stepped.type != IMPACT_OUT)
+            {
+                // Leaving the field is only checked at whole ticks by both, contacts are compared by time
+                float error = fabsf(steppedTick - solvedTick);
+
+                if (error > largestTickError) largestTickError = error;
+                if (error > TICK_TOLERANCE) tickMismatches++;
+            }
+
+            PlayMatchShot(&match, angle, power);
+        }
+    }
+
+    printf("%d shots over %d matches\n", shots, matches);
+    printf("stepped (1 tick):  %8.2f ms  %8.3f us/shot\n", steppedTime, 1000.0*steppedTime/shots);
+    printf("stepped (%d ticks): %8.2f ms  %8.3f us/shot\n", COARSE_TICKS_PER_STEP, coarseTime, 1000.0*coarseTime/shots);
+    printf("solved:            %8.2f ms  %8.3f us/shot\n", solvedTime, 1000.0*solvedTime/shots);
+    printf("type mismatches %d, target mismatches %d, contact ticks further than %.2f apart %d (largest %.4f)\n",
+           typeMismatches, targetMismatches, TICK_TOLERANCE, tickMismatches, largestTickError);
+
+    return 0;
+}
@@ -0,0 +1,96 @@
+// Vectorized environment benchmark: env steps per second of a batch of headless matches with random shots,
+// from 1 thread to every core, with an observation after every step. Usage: vecenv_bench [envs] [max threads]
+#define _POSIX_C_SOURCE 199309L
+
+#include "jobs.h"
+#include "vecenv.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define BENCH_STEPS                     200        // Batch steps per run
+#define DEFAULT_ENVS                    256
+#define SHOT_MAX_POWER                  150        // Random shots, stronger ones mostly leave the field
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+int main(int argc, char *argv[])
+{
+    int envs = (argc > 1)? atoi(argv[1]) : DEFAULT_ENVS;
+    int maxThreads = (argc > 2)? atoi(argv[2]) : GetCpuCount();
+    if (envs < 1) envs = 1;
+    if (maxThreads < 1) maxThreads = 1;
+    if (maxThreads > MAX_JOB_WORKERS + 1) maxThreads = MAX_JOB_WORKERS + 1;
+
+    // Caller buffers, reused by every step
+    int *action = (int *)malloc(2*envs*sizeof(int));
+    float *reward = (float *)malloc(envs*sizeof(float));
+    unsigned char *done = (unsigned char *)malloc(envs);
+    float *observation = (float *)malloc((size_t)envs*VEC_ENV_OBSERVATION_SIZE*sizeof(float));
+
+    VecEnv env = { 0 };
+    if ((action == NULL) || (reward == NULL) || (done == NULL) || (observation == NULL) || !InitVecEnv(&env, envs)) return 1;
+
+    printf("%d envs, %d steps, %d floats per observation\n\n", envs, BENCH_STEPS, VEC_ENV_OBSERVATION_SIZE);
+    printf("%8s %12s %14s %9s %10s %12s\n", "threads", "ms", "steps/s", "speedup", "episodes", "reward sum");
+
+    double base = 0.0;
+
+    for (int threads = 1; threads <= maxThreads; threads++)
+    {
+        // The calling thread runs ranges too, it counts as one of the threads
+        InitJobSystem(threads - 1, false);
+
+        // Same seeds and actions for every thread count, the results must not change
+        unsigned int random = 12345u;
+        int episodes = 0;
+        double rewardSum = 0.0;
+
+        ResetVecEnv(&env, 1000u);
+        ObserveVecEnv(&env, observation);
+
+        double start = GetMilliseconds();
+
+        for (int s = 0; s < BENCH_STEPS; s++)
+        {
+            for (int i = 0; i < envs; i++)
+            {
+                random = random*1664525u + 1013904223u;
+                action[2*i] = 1 + (random >> 8)%90;
+                action[2*i + 1] = 1 + (random >> 20)%SHOT_MAX_POWER;
+            }
+
+            StepVecEnv(&env, action, reward, done);
+            ObserveVecEnv(&env, observation);
+
+            for (int i = 0; i < envs; i++)
+            {
+                episodes += done[i];
+                rewardSum += reward[i];
+            }
+        }
+
+        double elapsed = GetMilliseconds() - start;
+
+        CloseJobSystem();
+
+        if (threads == 1) base = elapsed;
+
+        printf("%8d %12.2f %14.0f %8.2fx %10d %12.3f\n", threads, elapsed, 1000.0*BENCH_STEPS*envs/elapsed, base/elapsed, episodes, rewardSum);
+    }
+
+    CloseVecEnv(&env);
+    free(observation);
+    free(done);
+    free(reward);
+    free(action);
+
+    return 0;
+}
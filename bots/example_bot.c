@@ -0,0 +1,95 @@
+// Example bot: tries every shot and keeps the one landing closest to an enemy.
+// Build: make bots, play: ./Gorilla --bot 2 bots/example_bot.so
+#include "bot.h"
+
+#include <math.h>
+
+#define MAX_FLIGHT_TICKS               2000
+
+static int IsInsideBuilding(const GameView *view, float x, float y)
+{
+    for (int i = 0; i < view->craterCount; i++)
+    {
+        float dx = x - view->crater[i].x;
+        float dy = y - view->crater[i].y;
+
+        if (dx*dx + dy*dy < view->crater[i].radius*view->crater[i].radius) return 0;
+    }
+
+    for (int i = 0; i < view->buildingCount; i++)
+    {
+        const BotRectangle *rec = &view->building[i];
+
+        if ((x >= rec->x) && (x <= rec->x + rec->width) && (y >= rec->y) && (y <= rec->y + rec->height)) return 1;
+    }
+
+    return 0;
+}
+
+// Squared distance from the landing point to the target center, the projectile center is stepped tick by tick
+static float GetMissDistance(const GameView *view, int angle, int power, float targetX, float targetY)
+{
+    const BotPlayerView *self = &view->player[view->self];
+    float x = self->bounds.x + self->bounds.width/2;
+    float y = self->bounds.y + self->bounds.height/2;
+    float speedX = cosf(angle*3.14159265f/180.0f)*power*view->speedScale;
+    float speedY = -sinf(angle*3.14159265f/180.0f)*power*view->speedScale;
+
+    if (!self->isLeftTeam) speedX = -speedX;
+
+    float best = 1e30f;
+
+    for (int tick = 0; tick < MAX_FLIGHT_TICKS; tick++)
+    {
+        x += speedX;
+        y += speedY;
+        speedY += view->gravity;
+
+        float dx = x - targetX;
+        float dy = y - targetY;
+        float distance = dx*dx + dy*dy;
+
+        if (distance < best) best = distance;
+
+        // Our own building is cleared in the first ticks, later contacts end the flight
+        if ((x < 0) || (x > view->width) || (y > view->height)) break;
+        if ((tick > 5) && IsInsideBuilding(view, x, y)) break;
+    }
+
+    return best;
+}
+
+int choose_shot(const GameView *view, int *angle, int *power)
+{
+    if (view->apiVersion != BOT_API_VERSION) return 0;
+
+    int target = -1;
+
+    for (int i = 0; i < view->playerCount; i++)
+    {
+        if (view->player[i].isAlive && (view->player[i].isLeftTeam != view->player[view->self].isLeftTeam)) target = i;
+    }
+
+    if (target < 0) return 0;
+
+    float targetX = view->player[target].bounds.x + view->player[target].bounds.width/2;
+    float targetY = view->player[target].bounds.y + view->player[target].bounds.height/2;
+    float best = 1e30f;
+
+    for (int a = 1; a <= view->maxAngle; a++)
+    {
+        for (int p = 1; p <= view->maxPower; p += 2)
+        {
+            float miss = GetMissDistance(view, a, p, targetX, targetY);
+
+            if (miss < best)
+            {
+                best = miss;
+                *angle = a;
+                *power = p;
+            }
+        }
+    }
+
+    return 1;
+}
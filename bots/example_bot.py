@@ -0,0 +1,58 @@
+#!/usr/bin/env python3
+# Example external bot, pipe protocol of src/botprocess.h. Aims at the first enemy with the closed form
+# of the ballistic curve, ignoring buildings: the first angle from 60 degrees down that needs a valid power.
+# Play: ./Gorilla --bot-process 2 "python3 bots/example_bot.py"
+import math
+import sys
+
+
+def choose_shot(turn, players):
+    self_index, gravity, speed_scale, max_angle, max_power = int(turn[2]), float(turn[5]), float(turn[6]), int(turn[8]), int(turn[9])
+    me = players[self_index]
+    enemies = [p for p in players if p[4] and p[5] != me[5]]
+
+    if not enemies:
+        return 45, 100
+
+    target = enemies[0]
+    dx = abs((target[0] + target[2]/2) - (me[0] + me[2]/2))
+    dy = (target[1] + target[3]/2) - (me[1] + me[3]/2)
+
+    for angle in list(range(60, max_angle + 1)) + list(range(59, 0, -1)):
+        a = math.radians(angle)
+        height = dy + dx*math.tan(a)
+
+        if height <= 0:
+            continue
+
+        speed = math.sqrt(gravity*dx*dx/(2*math.cos(a)**2*height))
+        power = int(round(speed/speed_scale))
+
+        if 1 <= power <= max_power:
+            return angle, power
+
+    return 45, max_power
+
+
+def main():
+    turn = None
+    players = []
+
+    for line in sys.stdin:
+        fields = line.split()
+
+        if not fields:
+            continue
+        elif fields[0] == "turn":
+            turn = fields
+            players = []
+        elif fields[0] == "player":
+            players.append([float(v) for v in fields[1:5]] + [int(fields[5]), int(fields[6])])
+        elif fields[0] == "end" and turn is not None:
+            angle, power = choose_shot(turn, players)
+            sys.stdout.write("%s %d %d\n" % (turn[1], angle, power))
+            sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,94 @@
+#include "alloccheck.h"
+
+#include "raylib.h"
+
+#include <stdlib.h>
+
+#if defined(ALLOC_CHECK) && defined(__GLIBC__)
+    #define ALLOC_CHECK_ENABLED
+#endif
+
+#if defined(ALLOC_CHECK_ENABLED)
+
+// glibc entry points, the interposed functions forward to them
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+static unsigned int allocationCount = 0;
+static unsigned int violationCount = 0;
+
+// NOTE: Nothing in here may allocate or log, TraceLog() is only called outside the check
+static __thread bool checking = false;
+static __thread unsigned int threadViolations = 0;
+static __thread size_t firstViolationSize = 0;
+
+static void CountAllocation(size_t size)
+{
+    __atomic_add_fetch(&allocationCount, 1, __ATOMIC_RELAXED);
+
+    if (checking)
+    {
+        if (threadViolations == 0) firstViolationSize = size;
+        threadViolations++;
+        __atomic_add_fetch(&violationCount, 1, __ATOMIC_RELAXED);
+    }
+}
+
+void *malloc(size_t size)
+{
+    CountAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    CountAllocation(count*size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    CountAllocation(size);
+    return __libc_realloc(pointer, size);
+}
+
+bool IsAllocationCheckEnabled(void)
+{
+    return true;
+}
+
+void BeginAllocationCheck(void)
+{
+    threadViolations = 0;
+    checking = true;
+}
+
+unsigned int EndAllocationCheck(void)
+{
+    checking = false;
+
+    if (threadViolations > 0) TraceLog(LOG_WARNING, "ALLOC: %u heap allocations in steady state, first one of %zu bytes", threadViolations, firstViolationSize);
+
+    return threadViolations;
+}
+
+unsigned int GetAllocationCount(void)
+{
+    return __atomic_load_n(&allocationCount, __ATOMIC_RELAXED);
+}
+
+unsigned int GetAllocationViolations(void)
+{
+    return __atomic_load_n(&violationCount, __ATOMIC_RELAXED);
+}
+
+#else
+
+bool IsAllocationCheckEnabled(void) { return false; }
+void BeginAllocationCheck(void) { }
+unsigned int EndAllocationCheck(void) { return 0; }
+unsigned int GetAllocationCount(void) { return 0; }
+unsigned int GetAllocationViolations(void) { return 0; }
+
+#endif
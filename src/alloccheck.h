@@ -0,0 +1,16 @@
+#ifndef ALLOCCHECK_H
+#define ALLOCCHECK_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Steady state allocation check: built with ALLOC_CHECK (make alloc-check), malloc(), calloc() and realloc() are counted,
+// and any call made by a thread between BeginAllocationCheck() and EndAllocationCheck() is a violation.
+// NOTE: Interposition needs glibc, other builds count nothing and never fail
+bool IsAllocationCheckEnabled(void);
+void BeginAllocationCheck(void);                    // Allocations on this thread are violations from now on
+unsigned int EndAllocationCheck(void);              // Violations since BeginAllocationCheck(), logged when not 0
+unsigned int GetAllocationCount(void);              // Every allocation since startup, on any thread
+unsigned int GetAllocationViolations(void);         // Every violation since startup, on any thread
+
+#endif // ALLOCCHECK_H
@@ -0,0 +1,55 @@
+#include "arena.h"
+
+#include "raylib.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool InitArena(Arena *arena, size_t capacity)
+{
+    *arena = (Arena){ 0 };
+    arena->memory = (unsigned char *)malloc(capacity);
+
+    if (arena->memory == NULL)
+    {
+        TraceLog(LOG_WARNING, "ARENA: Failed to allocate %zu bytes", capacity);
+        return false;
+    }
+
+    arena->capacity = capacity;
+
+    return true;
+}
+
+void CloseArena(Arena *arena)
+{
+    free(arena->memory);
+    *arena = (Arena){ 0 };
+}
+
+void *ArenaAlloc(Arena *arena, size_t size)
+{
+    // NOTE: The address is aligned, not the offset, malloc() only guarantees 8 bytes on some targets
+    uintptr_t base = (uintptr_t)arena->memory;
+    size_t offset = (size_t)(((base + arena->used + ARENA_ALIGNMENT - 1) & ~(uintptr_t)(ARENA_ALIGNMENT - 1)) - base);
+
+    if ((arena->memory == NULL) || (offset > arena->capacity) || (size > arena->capacity - offset))
+    {
+        TraceLog(LOG_WARNING, "ARENA: Out of memory, %zu bytes requested, %zu of %zu used", size, arena->used, arena->capacity);
+        return NULL;
+    }
+
+    arena->used = offset + size;
+    if (arena->used > arena->peak) arena->peak = arena->used;
+
+    void *block = arena->memory + offset;
+    memset(block, 0, size);
+
+    return block;
+}
+
+void ResetArena(Arena *arena)
+{
+    arena->used = 0;
+}
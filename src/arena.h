@@ -0,0 +1,23 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define ARENA_ALIGNMENT                  16        // Enough for any type, SIMD loads included
+
+// Linear allocator over one block allocated up front: allocating is a bump of used, freeing is resetting the whole arena.
+// NOTE: Nothing is freed individually, everything allocated since the last reset shares one lifetime (a match)
+typedef struct Arena {
+    unsigned char *memory;
+    size_t capacity;
+    size_t used;
+    size_t peak;                        // Highest use since InitArena(), to size the capacity
+} Arena;
+
+bool InitArena(Arena *arena, size_t capacity);     // The only heap allocation of the arena
+void CloseArena(Arena *arena);
+void *ArenaAlloc(Arena *arena, size_t size);        // Zeroed and aligned, NULL once the arena is full
+void ResetArena(Arena *arena);                      // Release every allocation at once
+
+#endif // ARENA_H
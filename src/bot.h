@@ -0,0 +1,67 @@
+#ifndef BOT_H
+#define BOT_H
+
+// Bot ABI: a bot is a shared library exporting
+//
+//     int choose_shot(const GameView *view, int *angle, int *power);
+//
+// called on the bot thread once per turn of a player it controls. It returns non-zero once angle and power are set,
+// a bot that returns 0, answers out of range or misses the turn budget gets the fallback shot (its previous one).
+// NOTE: Plain C types only so bots do not need raylib, any layout change bumps BOT_API_VERSION
+#define BOT_API_VERSION                   1
+#define BOT_ENTRY_POINT       "choose_shot"
+
+#define BOT_MAX_PLAYERS                   8
+#define BOT_MAX_BUILDINGS                64
+#define BOT_MAX_CRATERS                 256
+
+typedef struct BotRectangle {
+    float x;
+    float y;
+    float width;
+    float height;
+} BotRectangle;
+
+typedef struct BotCrater {
+    float x;
+    float y;
+    float radius;
+} BotCrater;
+
+typedef struct BotPlayerView {
+    BotRectangle bounds;
+    int isAlive;
+    int isLeftTeam;
+} BotPlayerView;
+
+// Everything a bot may look at, a copy made when its turn starts.
+// Coordinates are in pixels, y grows downwards. A shot starts at the center of the player, its speed in pixels per tick is
+// (cos(angle)*power*speedScale, -sin(angle)*power*speedScale), x mirrored for the right team. Every tick the projectile
+// moves by its speed, then gravity is added to the vertical speed
+typedef struct GameView {
+    int apiVersion;                     // BOT_API_VERSION of the game
+    int width;
+    int height;
+    float gravity;                      // Pixels per tick, per tick
+    float speedScale;
+    float projectileRadius;
+    int maxAngle;                       // Valid shots: angle in [1, maxAngle] degrees, power in [1, maxPower]
+    int maxPower;
+
+    int self;                           // Player controlled by the bot
+    int previousAngle;                  // Last shot of this player, 0 before its first one
+    int previousPower;
+    float impactX;                      // Where that shot hit, negative before the first one
+    float impactY;
+
+    int playerCount;
+    BotPlayerView player[BOT_MAX_PLAYERS];
+    int buildingCount;
+    BotRectangle building[BOT_MAX_BUILDINGS];
+    int craterCount;                    // Holes blown in the buildings, shots fly through them
+    BotCrater crater[BOT_MAX_CRATERS];
+} GameView;
+
+typedef int (*BotChooseShot)(const GameView *view, int *angle, int *power);
+
+#endif // BOT_H
@@ -0,0 +1,413 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "botplayer.h"
+#include "botprocess.h"
+
+#include "raylib.h"
+
+#include "gorilla.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <dlfcn.h>
+    #include <pthread.h>
+    #include <sys/stat.h>
+    #define BOT_LIBRARIES_ENABLED
+#endif
+
+#define BOT_FILE_NAME_LENGTH            256
+#define BOT_PROCESS_MAX_SHOTS             8        // Answers read per poll, stale ones included
+
+#if defined(BOT_LIBRARIES_ENABLED)
+
+typedef struct BotLibrary {
+    char fileName[BOT_FILE_NAME_LENGTH];
+    void *handle;
+    BotChooseShot chooseShot;
+    struct timespec modified;           // Library file time when it was loaded
+} BotLibrary;
+
+static BotLibrary bot[MAX_PLAYERS] = { 0 };
+static float budget = BOT_DEFAULT_BUDGET;
+
+// NOTE: One request at a time, players take turns. Every request gets a new id, answers to older ones are dropped
+static pthread_t botThread;
+static pthread_mutex_t botMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t botCondition = PTHREAD_COND_INITIALIZER;
+static bool threadStarted = false;
+static bool threadRunning = false;
+static bool threadBusy = false;         // Inside a bot, whatever request it is answering
+
+static unsigned int requestId = 0;
+static bool requestPending = false;     // Not taken by the bot thread yet
+static int requestPlayer = -1;
+static GameView requestView = { 0 };
+static double requestDeadline = 0.0;
+static int fallbackAngle = BOT_FALLBACK_ANGLE;
+static int fallbackPower = BOT_FALLBACK_POWER;
+
+static unsigned int answerId = 0;
+static bool answerValid = false;
+static int answerAngle = 0;
+static int answerPower = 0;
+
+// External bots answer through their pipes, the simulation polls them without any thread
+static BotProcess process[MAX_PLAYERS];
+static bool processStarted[MAX_PLAYERS] = { 0 };
+static unsigned int processTurn = 0;    // Turn sent to the process of requestPlayer, 0 if it could not be sent
+
+// NOTE: Not GetTime(), bots also play in headless tools without a window
+static double GetSeconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec/1000000000.0;
+}
+
+static bool IsShotValid(const GameView *view, int angle, int power)
+{
+    return (angle >= 1) && (angle <= view->maxAngle) && (power >= 1) && (power <= view->maxPower);
+}
+
+static void *BotLoop(void *data)
+{
+    (void)data;
+
+    // NOTE: Static, a GameView is too large for comfort on a thread stack
+    static GameView view = { 0 };
+
+    pthread_mutex_lock(&botMutex);
+
+    while (threadRunning)
+    {
+        if (!requestPending)
+        {
+            pthread_cond_wait(&botCondition, &botMutex);
+            continue;
+        }
+
+        unsigned int id = requestId;
+        BotChooseShot chooseShot = bot[requestPlayer].chooseShot;
+
+        view = requestView;
+        requestPending = false;
+        threadBusy = true;
+        pthread_mutex_unlock(&botMutex);
+
+        int angle = 0;
+        int power = 0;
+        bool chosen = (chooseShot != NULL) && (chooseShot(&view, &angle, &power) != 0);
+
+        pthread_mutex_lock(&botMutex);
+        threadBusy = false;
+
+        if (id == requestId)
+        {
+            answerId = id;
+            answerValid = chosen && IsShotValid(&view, angle, power);
+            answerAngle = angle;
+            answerPower = power;
+        }
+    }
+
+    pthread_mutex_unlock(&botMutex);
+
+    return NULL;
+}
+
+static bool GetFileTime(const char *fileName, struct timespec *time)
+{
+    struct stat info;
+    if (stat(fileName, &info) != 0) return false;
+
+    *time = info.st_mtim;
+
+    return true;
+}
+
+static bool OpenBotLibrary(BotLibrary *library)
+{
+    void *handle = dlopen(library->fileName, RTLD_NOW | RTLD_LOCAL);
+
+    if (handle == NULL)
+    {
+        TraceLog(LOG_WARNING, "BOT: [%s] Failed to load: %s", library->fileName, dlerror());
+        return false;
+    }
+
+    BotChooseShot chooseShot = NULL;
+    *(void **)&chooseShot = dlsym(handle, BOT_ENTRY_POINT);     // NOTE: ISO C has no object to function pointer cast
+
+    if (chooseShot == NULL)
+    {
+        TraceLog(LOG_WARNING, "BOT: [%s] No %s() entry point", library->fileName, BOT_ENTRY_POINT);
+        dlclose(handle);
+        return false;
+    }
+
+    library->handle = handle;
+    library->chooseShot = chooseShot;
+    GetFileTime(library->fileName, &library->modified);
+
+    return true;
+}
+
+bool LoadBot(int player, const char *fileName)
+{
+    if ((player < 0) || (player >= MAX_PLAYERS) || (strlen(fileName) >= BOT_FILE_NAME_LENGTH)) return false;
+
+    BotLibrary *library = &bot[player];
+
+    pthread_mutex_lock(&botMutex);
+
+    // NOTE: A path without a slash would be searched in the library paths, not in the working directory
+    if (strchr(fileName, '/') == NULL) snprintf(library->fileName, BOT_FILE_NAME_LENGTH, "./%s", fileName);
+    else snprintf(library->fileName, BOT_FILE_NAME_LENGTH, "%s", fileName);
+
+    bool loaded = OpenBotLibrary(library);
+
+    if (loaded && !threadStarted)
+    {
+        threadRunning = true;
+        threadStarted = (pthread_create(&botThread, NULL, BotLoop, NULL) == 0);
+
+        if (!threadStarted)
+        {
+            TraceLog(LOG_WARNING, "BOT: Failed to start the bot thread");
+            dlclose(library->handle);
+            library->handle = NULL;
+            library->chooseShot = NULL;
+            loaded = false;
+        }
+    }
+
+    pthread_mutex_unlock(&botMutex);
+
+    if (loaded) TraceLog(LOG_INFO, "BOT: [%s] Playing as player %i", library->fileName, player + 1);
+
+    return loaded;
+}
+
+bool LoadBotProcess(int player, const char *command)
+{
+    if ((player < 0) || (player >= MAX_PLAYERS)) return false;
+
+    if (processStarted[player]) StopBotProcess(&process[player]);
+    processStarted[player] = StartBotProcess(&process[player], command);
+
+    if (processStarted[player]) TraceLog(LOG_INFO, "BOT: [%s] Playing as player %i", command, player + 1);
+
+    return processStarted[player];
+}
+
+void SetBotBudget(float seconds)
+{
+    budget = seconds;
+}
+
+bool IsBotPlayer(int player)
+{
+    return (player >= 0) && (player < MAX_PLAYERS) && ((bot[player].chooseShot != NULL) || processStarted[player]);
+}
+
+void RequestBotShot(int player, const GameView *view)
+{
+    pthread_mutex_lock(&botMutex);
+
+    requestId++;
+    requestPending = !processStarted[player];      // External bots do not go through the bot thread
+    requestPlayer = player;
+    requestView = *view;
+    requestDeadline = GetSeconds() + budget;
+
+    if (IsShotValid(view, view->previousAngle, view->previousPower))
+    {
+        fallbackAngle = view->previousAngle;
+        fallbackPower = view->previousPower;
+    }
+    else
+    {
+        fallbackAngle = BOT_FALLBACK_ANGLE;
+        fallbackPower = BOT_FALLBACK_POWER;
+    }
+
+    if (processStarted[player]) processTurn = SendBotTurn(&process[player], view);
+    else pthread_cond_signal(&botCondition);
+
+    pthread_mutex_unlock(&botMutex);
+}
+
+// Answers to earlier turns are read and dropped, a bot that failed falls back right away
+static bool PollBotProcess(int player, int *angle, int *power)
+{
+    bool answered = false;
+    bool valid = false;
+    bool failed = (processTurn == 0);
+
+    while (!answered && !failed)
+    {
+        BotShot shot[BOT_PROCESS_MAX_SHOTS] = { 0 };
+        int count = ReceiveBotShots(&process[player], shot, BOT_PROCESS_MAX_SHOTS, 0);
+
+        if (count < 0) failed = true;
+        else if (count == 0) break;
+
+        for (int i = 0; i < count; i++)
+        {
+            if (shot[i].id != processTurn) continue;
+
+            answered = true;
+            valid = IsShotValid(&requestView, shot[i].angle, shot[i].power);
+            *angle = shot[i].angle;
+            *power = shot[i].power;
+        }
+    }
+
+    bool overrun = !answered && !failed && (GetSeconds() > requestDeadline);
+
+    if (!valid && (answered || failed || overrun))
+    {
+        *angle = fallbackAngle;
+        *power = fallbackPower;
+    }
+
+    if (overrun) TraceLog(LOG_WARNING, "BOT: Player %i over its %.0f ms budget, fallback shot", player + 1, budget*1000.0f);
+    else if (failed) TraceLog(LOG_WARNING, "BOT: Player %i process is not answering, fallback shot", player + 1);
+    else if (answered && !valid) TraceLog(LOG_WARNING, "BOT: Player %i gave no valid shot, fallback shot", player + 1);
+
+    if (answered || failed || overrun) processTurn = 0;
+
+    return answered || failed || overrun;
+}
+
+bool PollBotShot(int player, int *angle, int *power)
+{
+    if (processStarted[player]) return PollBotProcess(player, angle, power);
+
+    pthread_mutex_lock(&botMutex);
+
+    bool answered = (answerId == requestId) && (requestPlayer == player);
+    bool valid = answerValid;
+    bool overrun = !answered && (GetSeconds() > requestDeadline);
+
+    if (answered && valid)
+    {
+        *angle = answerAngle;
+        *power = answerPower;
+    }
+    else if (answered || overrun)
+    {
+        *angle = fallbackAngle;
+        *power = fallbackPower;
+    }
+
+    // The request is closed, a late answer will not match the next one
+    if (overrun) requestId++;
+    requestPending = requestPending && !overrun;
+
+    pthread_mutex_unlock(&botMutex);
+
+    if (overrun) TraceLog(LOG_WARNING, "BOT: Player %i over its %.0f ms budget, fallback shot", player + 1, budget*1000.0f);
+    else if (answered && !valid) TraceLog(LOG_WARNING, "BOT: Player %i gave no valid shot, fallback shot", player + 1);
+
+    return answered || overrun;
+}
+
+void CancelBotShots(void)
+{
+    pthread_mutex_lock(&botMutex);
+    requestId++;
+    requestPending = false;
+    pthread_mutex_unlock(&botMutex);
+}
+
+void ReloadChangedBots(void)
+{
+    pthread_mutex_lock(&botMutex);
+
+    // NOTE: Only while no bot code runs. Replace the file (mv, install), writing over a mapped library crashes the game
+    if (!threadBusy && !requestPending)
+    {
+        for (int i = 0; i < MAX_PLAYERS; i++)
+        {
+            BotLibrary *library = &bot[i];
+            struct timespec modified = { 0 };
+
+            if ((library->handle == NULL) || !GetFileTime(library->fileName, &modified)) continue;
+            if ((modified.tv_sec == library->modified.tv_sec) && (modified.tv_nsec == library->modified.tv_nsec)) continue;
+
+            dlclose(library->handle);
+            library->handle = NULL;
+            library->chooseShot = NULL;
+
+            if (OpenBotLibrary(library)) TraceLog(LOG_INFO, "BOT: [%s] Reloaded", library->fileName);
+        }
+    }
+
+    pthread_mutex_unlock(&botMutex);
+}
+
+void UnloadBots(void)
+{
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        if (processStarted[i]) StopBotProcess(&process[i]);
+        processStarted[i] = false;
+    }
+
+    if (!threadStarted) return;
+
+    pthread_mutex_lock(&botMutex);
+    bool busy = threadBusy;
+    threadRunning = false;
+    pthread_cond_signal(&botCondition);
+    pthread_mutex_unlock(&botMutex);
+
+    // A runaway bot would block the exit, its thread and library are left to the process end
+    if (busy)
+    {
+        pthread_detach(botThread);
+        return;
+    }
+
+    pthread_join(botThread, NULL);
+    threadStarted = false;
+
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        if (bot[i].handle != NULL) dlclose(bot[i].handle);
+        bot[i] = (BotLibrary){ 0 };
+    }
+}
+
+#else
+
+bool LoadBot(int player, const char *fileName)
+{
+    (void)player;
+    TraceLog(LOG_WARNING, "BOT: [%s] Bot libraries are not supported on this platform", fileName);
+
+    return false;
+}
+
+bool LoadBotProcess(int player, const char *command)
+{
+    (void)player;
+    TraceLog(LOG_WARNING, "BOT: [%s] Bot processes are not supported on this platform", command);
+
+    return false;
+}
+
+void SetBotBudget(float seconds) { (void)seconds; }
+bool IsBotPlayer(int player) { (void)player; return false; }
+void RequestBotShot(int player, const GameView *view) { (void)player; (void)view; }
+bool PollBotShot(int player, int *angle, int *power) { (void)player; *angle = BOT_FALLBACK_ANGLE; *power = BOT_FALLBACK_POWER; return true; }
+void CancelBotShots(void) { }
+void ReloadChangedBots(void) { }
+void UnloadBots(void) { }
+
+#endif
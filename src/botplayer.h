@@ -0,0 +1,26 @@
+#ifndef BOTPLAYER_H
+#define BOTPLAYER_H
+
+#include "bot.h"
+
+#include <stdbool.h>
+
+#define BOT_DEFAULT_BUDGET            0.50f        // Seconds of wall-clock time per turn
+#define BOT_FALLBACK_ANGLE               45        // Shot of a bot without a previous valid one
+#define BOT_FALLBACK_POWER              100
+
+// Bot libraries, loaded with dlopen() and run on their own thread: the simulation hands a GameView over and polls for the shot.
+// External bots get the same GameView through a pipe and are polled the same way.
+// NOTE: A bot cannot be interrupted, after an overrun its turn gets the fallback shot and later answers are dropped.
+// Until a runaway bot returns, every new turn falls back as well. Not available on the web
+bool LoadBot(int player, const char *fileName);         // False if the library or its entry point is missing
+bool LoadBotProcess(int player, const char *command);   // External bot speaking the pipe protocol of botprocess.h
+void SetBotBudget(float seconds);
+bool IsBotPlayer(int player);
+void RequestBotShot(int player, const GameView *view);  // Start thinking, the budget starts now
+bool PollBotShot(int player, int *angle, int *power);   // True once the bot answered, or the fallback shot if its budget ran out
+void CancelBotShots(void);                              // Drop the pending request and any answer to it (restart, load)
+void ReloadChangedBots(void);                           // Load the libraries replaced since they were loaded, between matches
+void UnloadBots(void);
+
+#endif // BOTPLAYER_H
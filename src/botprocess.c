@@ -0,0 +1,292 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "botprocess.h"
+
+#include "raylib.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <fcntl.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <spawn.h>
+    #include <sys/wait.h>
+    #include <unistd.h>
+    #define BOT_PROCESSES_ENABLED
+#endif
+
+#define BOT_PROCESS_EXIT_WAIT            100       // Milliseconds a bot gets to exit once its stdin is closed
+
+#if defined(BOT_PROCESSES_ENABLED)
+
+extern char **environ;
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+static void SetPipeFlags(int file)
+{
+    fcntl(file, F_SETFL, fcntl(file, F_GETFL) | O_NONBLOCK);
+    fcntl(file, F_SETFD, fcntl(file, F_GETFD) | FD_CLOEXEC);   // Other bots must not keep this pipe open
+}
+
+bool StartBotProcess(BotProcess *bot, const char *command)
+{
+    int toBot[2] = { -1, -1 };
+    int fromBot[2] = { -1, -1 };
+
+    bot->pid = 0;
+    bot->input = -1;
+    bot->output = -1;
+    bot->failed = true;
+    bot->lastId = 0;
+    bot->sendStart = 0;
+    bot->sendLength = 0;
+    bot->receiveLength = 0;
+
+    if ((pipe(toBot) != 0) || (pipe(fromBot) != 0))
+    {
+        TraceLog(LOG_WARNING, "BOT: Failed to create the pipes: %s", strerror(errno));
+        if (toBot[0] >= 0) { close(toBot[0]); close(toBot[1]); }
+        return false;
+    }
+
+    // A bot closing its stdin must not kill the game, writes fail with EPIPE instead
+    struct sigaction ignore = { 0 };
+    ignore.sa_handler = SIG_IGN;
+    sigaction(SIGPIPE, &ignore, NULL);
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, toBot[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, fromBot[1], STDOUT_FILENO);
+    posix_spawn_file_actions_addclose(&actions, toBot[0]);
+    posix_spawn_file_actions_addclose(&actions, toBot[1]);
+    posix_spawn_file_actions_addclose(&actions, fromBot[0]);
+    posix_spawn_file_actions_addclose(&actions, fromBot[1]);
+
+    char *arguments[] = { "sh", "-c", (char *)command, NULL };
+    pid_t pid = 0;
+    int result = posix_spawn(&pid, "/bin/sh", &actions, NULL, arguments, environ);
+
+    posix_spawn_file_actions_destroy(&actions);
+    close(toBot[0]);
+    close(fromBot[1]);
+
+    if (result != 0)
+    {
+        TraceLog(LOG_WARNING, "BOT: [%s] Failed to start: %s", command, strerror(result));
+        close(toBot[1]);
+        close(fromBot[0]);
+        return false;
+    }
+
+    SetPipeFlags(toBot[1]);
+    SetPipeFlags(fromBot[0]);
+
+    bot->pid = (int)pid;
+    bot->input = toBot[1];
+    bot->output = fromBot[0];
+    bot->failed = false;
+
+    TraceLog(LOG_INFO, "BOT: [%s] Started, process %i", command, bot->pid);
+
+    return true;
+}
+
+// Write what the pipe accepts without blocking
+static void FlushBotProcess(BotProcess *bot)
+{
+    while (!bot->failed && (bot->sendStart < bot->sendLength))
+    {
+        ssize_t written = write(bot->input, bot->sendBuffer + bot->sendStart, bot->sendLength - bot->sendStart);
+
+        if (written > 0) bot->sendStart += (int)written;
+        else if ((written < 0) && (errno == EINTR)) continue;
+        else if ((written < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK))) break;
+        else bot->failed = true;
+    }
+
+    if (bot->sendStart == bot->sendLength) bot->sendStart = bot->sendLength = 0;
+}
+
+static void AppendText(BotProcess *bot, const char *format, ...)
+{
+    int space = BOT_PROCESS_SEND_SIZE - bot->sendLength;
+
+    va_list arguments;
+    va_start(arguments, format);
+    int length = vsnprintf(bot->sendBuffer + bot->sendLength, space, format, arguments);
+    va_end(arguments);
+
+    // NOTE: Room for a whole turn is checked before, a longer one would only be truncated
+    if ((length > 0) && (length < space)) bot->sendLength += length;
+}
+
+unsigned int SendBotTurn(BotProcess *bot, const GameView *view)
+{
+    if (bot->failed) return 0;
+
+    FlushBotProcess(bot);
+
+    // Make room behind what is still queued
+    if (BOT_PROCESS_SEND_SIZE - bot->sendLength < BOT_PROCESS_TURN_SIZE)
+    {
+        memmove(bot->sendBuffer, bot->sendBuffer + bot->sendStart, bot->sendLength - bot->sendStart);
+        bot->sendLength -= bot->sendStart;
+        bot->sendStart = 0;
+
+        if (BOT_PROCESS_SEND_SIZE - bot->sendLength < BOT_PROCESS_TURN_SIZE) return 0;
+    }
+
+    unsigned int id = ++bot->lastId;
+    if (id == 0) id = ++bot->lastId;
+
+    AppendText(bot, "turn %u %i %i %i %.9g %.9g %.9g %i %i %i %i %.9g %.9g\n", id, view->self, view->width, view->height, view->gravity,
+               view->speedScale, view->projectileRadius, view->maxAngle, view->maxPower, view->previousAngle, view->previousPower, view->impactX, view->impactY);
+
+    for (int i = 0; i < view->playerCount; i++)
+    {
+        const BotPlayerView *player = &view->player[i];
+        AppendText(bot, "player %.9g %.9g %.9g %.9g %i %i\n", player->bounds.x, player->bounds.y, player->bounds.width, player->bounds.height, player->isAlive, player->isLeftTeam);
+    }
+
+    for (int i = 0; i < view->buildingCount; i++)
+    {
+        const BotRectangle *rec = &view->building[i];
+        AppendText(bot, "building %.9g %.9g %.9g %.9g\n", rec->x, rec->y, rec->width, rec->height);
+    }
+
+    for (int i = 0; i < view->craterCount; i++)
+    {
+        AppendText(bot, "crater %.9g %.9g %.9g\n", view->crater[i].x, view->crater[i].y, view->crater[i].radius);
+    }
+
+    AppendText(bot, "end\n");
+    FlushBotProcess(bot);
+
+    return bot->failed? 0 : id;
+}
+
+// Complete answer lines already received, malformed ones are skipped
+static int ParseBotShots(BotProcess *bot, BotShot *shot, int maxShots)
+{
+    int count = 0;
+    int start = 0;
+
+    for (int i = 0; (i < bot->receiveLength) && (count < maxShots); i++)
+    {
+        if (bot->receiveBuffer[i] != '\n') continue;
+
+        bot->receiveBuffer[i] = '\0';
+
+        BotShot answer = { 0 };
+        if (sscanf(bot->receiveBuffer + start, "%u %i %i", &answer.id, &answer.angle, &answer.power) == 3) shot[count++] = answer;
+        else TraceLog(LOG_WARNING, "BOT: Process %i: invalid answer \"%s\"", bot->pid, bot->receiveBuffer + start);
+
+        start = i + 1;
+    }
+
+    memmove(bot->receiveBuffer, bot->receiveBuffer + start, bot->receiveLength - start);
+    bot->receiveLength -= start;
+
+    // A line that does not fit is garbage, drop it instead of stalling
+    if (bot->receiveLength == BOT_PROCESS_RECEIVE_SIZE) bot->receiveLength = 0;
+
+    return count;
+}
+
+int ReceiveBotShots(BotProcess *bot, BotShot *shot, int maxShots, int timeout)
+{
+    double deadline = GetMilliseconds() + timeout;
+
+    while (true)
+    {
+        int count = ParseBotShots(bot, shot, maxShots);
+
+        if (count > 0) return count;
+        if (bot->failed) return -1;
+
+        FlushBotProcess(bot);
+
+        int remaining = (int)(deadline - GetMilliseconds());
+        if (remaining < 0) remaining = 0;
+
+        struct pollfd files[2] = { { bot->output, POLLIN, 0 }, { bot->input, POLLOUT, 0 } };
+        int ready = poll(files, (bot->sendStart < bot->sendLength)? 2 : 1, remaining);
+
+        if ((ready < 0) && (errno != EINTR)) bot->failed = true;
+
+        if ((ready > 0) && (files[0].revents != 0))
+        {
+            ssize_t received = read(bot->output, bot->receiveBuffer + bot->receiveLength, BOT_PROCESS_RECEIVE_SIZE - bot->receiveLength);
+
+            if (received > 0) bot->receiveLength += (int)received;
+            else if ((received == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)))
+            {
+                TraceLog(LOG_WARNING, "BOT: Process %i closed its output", bot->pid);
+                bot->failed = true;
+            }
+
+            continue;
+        }
+
+        if (remaining == 0) return 0;
+    }
+}
+
+void StopBotProcess(BotProcess *bot)
+{
+    if (bot->input >= 0) close(bot->input);
+    if (bot->output >= 0) close(bot->output);
+
+    bot->input = -1;
+    bot->output = -1;
+    bot->failed = true;
+
+    if (bot->pid <= 0) return;
+
+    // Closing stdin asks the bot to exit, one that does not gets killed
+    double deadline = GetMilliseconds() + BOT_PROCESS_EXIT_WAIT;
+
+    while (waitpid(bot->pid, NULL, WNOHANG) == 0)
+    {
+        if (GetMilliseconds() > deadline)
+        {
+            kill(bot->pid, SIGKILL);
+            waitpid(bot->pid, NULL, 0);
+            break;
+        }
+
+        struct timespec pause = { 0, 1000000 };
+        nanosleep(&pause, NULL);
+    }
+
+    bot->pid = 0;
+}
+
+#else
+
+bool StartBotProcess(BotProcess *bot, const char *command)
+{
+    bot->failed = true;
+    TraceLog(LOG_WARNING, "BOT: [%s] Bot processes are not supported on this platform", command);
+
+    return false;
+}
+
+unsigned int SendBotTurn(BotProcess *bot, const GameView *view) { (void)bot; (void)view; return 0; }
+int ReceiveBotShots(BotProcess *bot, BotShot *shot, int maxShots, int timeout) { (void)bot; (void)shot; (void)maxShots; (void)timeout; return -1; }
+void StopBotProcess(BotProcess *bot) { (void)bot; }
+
+#endif
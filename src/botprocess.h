@@ -0,0 +1,48 @@
+#ifndef BOTPROCESS_H
+#define BOTPROCESS_H
+
+#include "bot.h"
+
+#include <stdbool.h>
+
+#define BOT_PROCESS_SEND_SIZE     (256*1024)       // Requests not written to the pipe yet
+#define BOT_PROCESS_RECEIVE_SIZE       4096        // Partial answer lines
+#define BOT_PROCESS_TURN_SIZE     (32*1024)        // Longest turn message, every list full
+
+// External bot: a child process started with /bin/sh -c <command>, turns are written to its stdin and shots read from its stdout.
+// Line protocol, numbers separated by spaces. For every turn the game sends:
+//
+//     turn <id> <self> <width> <height> <gravity> <speedScale> <projectileRadius> <maxAngle> <maxPower> <previousAngle> <previousPower> <impactX> <impactY>
+//     player <x> <y> <width> <height> <alive> <leftTeam>        one line per player
+//     building <x> <y> <width> <height>                          one line per building
+//     crater <x> <y> <radius>                                    one line per crater
+//     end
+//
+// and the bot answers with one line "<id> <angle> <power>". Field meanings are the ones of GameView (bot.h).
+// NOTE: Several turns may be in flight at once (tournaments pipeline their matches), answers can come in any order,
+// the id ties each one to its turn. Nothing is ever waited for without a timeout, a bot that dies or stalls only loses turns
+typedef struct BotProcess {
+    int pid;
+    int input;                          // Bot stdin, non-blocking
+    int output;                         // Bot stdout, non-blocking
+    bool failed;                        // Exited or closed a pipe, no more answers
+    unsigned int lastId;
+    char sendBuffer[BOT_PROCESS_SEND_SIZE];
+    int sendStart;                      // Already written up to there
+    int sendLength;
+    char receiveBuffer[BOT_PROCESS_RECEIVE_SIZE];
+    int receiveLength;
+} BotProcess;
+
+typedef struct BotShot {
+    unsigned int id;
+    int angle;
+    int power;
+} BotShot;
+
+bool StartBotProcess(BotProcess *bot, const char *command);
+unsigned int SendBotTurn(BotProcess *bot, const GameView *view);                   // Returns the turn id, 0 if the bot failed or is too far behind
+int ReceiveBotShots(BotProcess *bot, BotShot *shot, int maxShots, int timeout);    // Answers that arrived within timeout ms (0 polls), -1 once the bot failed
+void StopBotProcess(BotProcess *bot);
+
+#endif // BOTPROCESS_H
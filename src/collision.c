@@ -0,0 +1,304 @@
+#include "collision.h"
+
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+
+#define SWEEP_EPSILON               1e-6f
+
+// Clip the line interval against one axis slab
+static bool ClipSlab(float origin, float direction, float min, float max, float *enter, float *exit)
+{
+    if (fabsf(direction) < SWEEP_EPSILON) return (origin >= min) && (origin <= max);
+
+    float a = (min - origin)/direction;
+    float b = (max - origin)/direction;
+
+    if (a > b)
+    {
+        float swap = a;
+        a = b;
+        b = swap;
+    }
+
+    if (a > *enter) *enter = a;
+    if (b < *exit) *exit = b;
+
+    return (*enter <= *exit);
+}
+
+static bool SweptPointBox(Vector2 start, Vector2 delta, float minX, float minY, float maxX, float maxY, float *enter, float *exit)
+{
+    *enter = -FLT_MAX;
+    *exit = FLT_MAX;
+
+    return ClipSlab(start.x, delta.x, minX, maxX, enter, exit) && ClipSlab(start.y, delta.y, minY, maxY, enter, exit);
+}
+
+bool SweptPointCircle(Vector2 start, Vector2 end, Vector2 center, float radius, float *enter, float *exit)
+{
+    Vector2 delta = { end.x - start.x, end.y - start.y };
+    Vector2 offset = { start.x - center.x, start.y - center.y };
+
+    float a = delta.x*delta.x + delta.y*delta.y;
+    float b = 2*(delta.x*offset.x + delta.y*offset.y);
+    float c = offset.x*offset.x + offset.y*offset.y - radius*radius;
+
+    // Not moving, either always inside or never
+    if (a < SWEEP_EPSILON)
+    {
+        *enter = -FLT_MAX;
+        *exit = FLT_MAX;
+        return (c <= 0);
+    }
+
+    float discriminant = b*b - 4*a*c;
+
+    if (discriminant < 0) return false;
+
+    float root = sqrtf(discriminant);
+
+    *enter = (-b - root)/(2*a);
+    *exit = (-b + root)/(2*a);
+
+    return true;
+}
+
+bool SweptCircleRec(Vector2 start, Vector2 end, float radius, Rectangle rec, float *enter, float *exit)
+{
+    // NOTE: The circle touches the rectangle while its center is inside the rectangle grown by the radius with rounded corners.
+    // That shape is convex, so the union of the intervals of its pieces (two crossed boxes and four corner discs) is a single interval.
+    Vector2 delta = { end.x - start.x, end.y - start.y };
+    Vector2 corners[4] = {
+        { rec.x, rec.y }, { rec.x + rec.width, rec.y },
+        { rec.x, rec.y + rec.height }, { rec.x + rec.width, rec.y + rec.height }
+    };
+    float a, b;
+    bool hit = false;
+
+    *enter = FLT_MAX;
+    *exit = -FLT_MAX;
+
+    if (SweptPointBox(start, delta, rec.x - radius, rec.y, rec.x + rec.width + radius, rec.y + rec.height, &a, &b))
+    {
+        if (a < *enter) *enter = a;
+        if (b > *exit) *exit = b;
+        hit = true;
+    }
+
+    if (SweptPointBox(start, delta, rec.x, rec.y - radius, rec.x + rec.width, rec.y + rec.height + radius, &a, &b))
+    {
+        if (a < *enter) *enter = a;
+        if (b > *exit) *exit = b;
+        hit = true;
+    }
+
+    for (int i = 0; i < 4; i++)
+    {
+        if (SweptPointCircle(start, end, corners[i], radius, &a, &b))
+        {
+            if (a < *enter) *enter = a;
+            if (b > *exit) *exit = b;
+            hit = true;
+        }
+    }
+
+    return hit;
+}
+
+static Rectangle GetPlayerRec(const Player *player)
+{
+    return (Rectangle){ player->position.x - player->size.x/2, player->position.y - player->size.y/2, player->size.x, player->size.y };
+}
+
+int FindFirstBuilding(const Building *building, int count, float x)
+{
+    int low = 0;
+    int high = count;
+
+    while (low < high)
+    {
+        int middle = low + (high - low)/2;
+
+        if (building[middle].rectangle.x + building[middle].rectangle.width > x) high = middle;
+        else low = middle + 1;
+    }
+
+    return low;
+}
+
+// Push time forward past every exclusion interval covering it
+static float SkipCovered(float time, const float *enter, const float *exit, int count)
+{
+    bool moved = true;
+
+    while (moved)
+    {
+        moved = false;
+
+        for (int i = 0; i < count; i++)
+        {
+            if ((time >= enter[i]) && (time < exit[i]))
+            {
+                time = exit[i];
+                moved = true;
+            }
+        }
+    }
+
+    return time;
+}
+
+Impact SweepProjectile(const CollisionWorld *world, Vector2 start, Vector2 end, float radius, int owner)
+{
+    Impact impact = { IMPACT_NONE, 1.0f, end, -1 };
+
+    // Box of the step, a pixel larger so touching is not lost: whatever does not overlap it is not on the way
+    Rectangle step = { fminf(start.x, end.x) - 1, fminf(start.y, end.y) - 1, fabsf(end.x - start.x) + 2, fabsf(end.y - start.y) + 2 };
+    Rectangle sweptStep = { step.x - radius, step.y - radius, step.width + 2*radius, step.height + 2*radius };
+
+    // While overlapping the shooter nothing is hit, which keeps the shot from hitting the roof it was fired from
+    float excludedEnter[MAX_EXPLOSIONS + 1];
+    float excludedExit[MAX_EXPLOSIONS + 1];
+    int excludedCount = 0;
+    bool cratersAdded = false;
+    float enter, exit;
+
+    if ((owner >= 0) && CheckCollisionRecs(GetPlayerRec(&world->player[owner]), sweptStep) &&
+        SweptCircleRec(start, end, radius, GetPlayerRec(&world->player[owner]), &enter, &exit))
+    {
+        excludedEnter[excludedCount] = enter;
+        excludedExit[excludedCount] = exit;
+        excludedCount++;
+    }
+
+    // Player collision
+    for (int i = 0; i < world->playerCount; i++)
+    {
+        if ((i == owner) || !world->player[i].isAlive || !CheckCollisionRecs(GetPlayerRec(&world->player[i]), sweptStep)) continue;
+
+        if (SweptCircleRec(start, end, radius, GetPlayerRec(&world->player[i]), &enter, &exit) && (exit >= 0) && (enter <= 1))
+        {
+            float time = SkipCovered((enter > 0)? enter : 0, excludedEnter, excludedExit, excludedCount);
+
+            if ((time <= exit) && (time <= 1) && ((impact.type == IMPACT_NONE) || (time < impact.time)))
+            {
+                impact.type = IMPACT_PLAYER;
+                impact.time = time;
+                impact.target = i;
+            }
+        }
+    }
+
+    // Building collision, only the ones under the step
+    // NOTE: We only collide with buildings where we are not inside an explosion
+    for (int i = FindFirstBuilding(world->building, world->buildingCount, sweptStep.x); i < world->buildingCount; i++)
+    {
+        if (world->building[i].rectangle.x >= sweptStep.x + sweptStep.width) break;
+        if (!CheckCollisionRecs(world->building[i].rectangle, sweptStep)) continue;
+
+        if (SweptCircleRec(start, end, radius, world->building[i].rectangle, &enter, &exit) && (exit >= 0) && (enter <= 1))
+        {
+            // Crater intervals are only needed once some building is on the way
+            if (!cratersAdded)
+            {
+                for (int j = 0; j < world->explosionCount; j++)
+                {
+                    const Explosion *crater = &world->explosion[j];
+
+                    float reach = (float)crater->radius;
+
+                    if (!crater->active || (crater->position.x + reach < step.x) || (crater->position.x - reach > step.x + step.width) ||
+                        (crater->position.y + reach < step.y) || (crater->position.y - reach > step.y + step.height)) continue;
+
+                    if (SweptPointCircle(start, end, crater->position, crater->radius, &excludedEnter[excludedCount], &excludedExit[excludedCount]) &&
+                        (excludedExit[excludedCount] >= 0) && (excludedEnter[excludedCount] <= 1)) excludedCount++;
+                }
+
+                cratersAdded = true;
+            }
+
+            float time = SkipCovered((enter > 0)? enter : 0, excludedEnter, excludedExit, excludedCount);
+
+            if ((time <= exit) && (time <= 1) && ((impact.type == IMPACT_NONE) || (time < impact.time)))
+            {
+                impact.type = IMPACT_BUILDING;
+                impact.time = time;
+                impact.target = i;
+            }
+        }
+    }
+
+    if (impact.type != IMPACT_NONE)
+    {
+        impact.position.x = start.x + (end.x - start.x)*impact.time;
+        impact.position.y = start.y + (end.y - start.y)*impact.time;
+    }
+    else if ((end.x + radius < 0) || (end.x - radius > world->width) || (end.y - radius > world->height))
+    {
+        impact.type = IMPACT_OUT;
+    }
+
+    return impact;
+}
+
+Impact SimulateShot(const CollisionWorld *world, Vector2 position, Vector2 speed, float radius, int owner, int ticksPerStep, int maxTicks, float *tick)
+{
+    const float gravity = GRAVITY/DELTA_FPS;
+    Impact impact = { IMPACT_NONE, 1.0f, position, -1 };
+    Vector2 start = position;
+
+    if (ticksPerStep < 1) ticksPerStep = 1;
+
+    for (int n = 0; n < maxTicks;)
+    {
+        // NOTE: Single ticks while leaving the shooter, coarse chords there would clip its own roof
+        bool leaving = (owner >= 0) && CheckCollisionCircleRec(start, radius, GetPlayerRec(&world->player[owner]));
+        int next = leaving? n + 1 : n + ticksPerStep;
+        if (next > maxTicks) next = maxTicks;
+
+        // Closed form of the per tick integration (move, then add gravity to the speed)
+        Vector2 end = { position.x + next*speed.x, position.y + next*speed.y + gravity*next*(next - 1)/2 };
+
+        impact = SweepProjectile(world, start, end, radius, owner);
+
+        if (impact.type != IMPACT_NONE)
+        {
+            if (tick != NULL) *tick = n + impact.time*(next - n);
+            return impact;
+        }
+
+        start = end;
+        n = next;
+    }
+
+    if (tick != NULL) *tick = (float)maxTicks;
+
+    return impact;
+}
+
+int TraceShot(const CollisionWorld *world, Vector2 position, Vector2 speed, float radius, int owner, Vector2 *points, int maxPoints)
+{
+    const float gravity = GRAVITY/DELTA_FPS;
+    int count = 0;
+
+    if (maxPoints < 1) return 0;
+
+    points[count++] = position;
+
+    while (count < maxPoints)
+    {
+        Vector2 end = { position.x + speed.x, position.y + speed.y };
+        Impact impact = SweepProjectile(world, position, end, radius, owner);
+
+        // Contact point, the end of the step otherwise (also once out of the field)
+        points[count++] = impact.position;
+        if (impact.type != IMPACT_NONE) break;
+
+        // Same order as MoveProjectiles(): move, then add gravity to the speed
+        position = end;
+        speed.y += gravity;
+    }
+
+    return count;
+}
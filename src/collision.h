@@ -0,0 +1,52 @@
+#ifndef COLLISION_H
+#define COLLISION_H
+
+#include "gorilla.h"
+
+typedef enum {
+    IMPACT_NONE = 0,                // Still flying
+    IMPACT_OUT,                     // Left the field through the sides or the bottom
+    IMPACT_BUILDING,                // Hit a building outside of any crater
+    IMPACT_PLAYER                   // Hit a player other than the shooter
+} ImpactType;
+
+typedef struct Impact {
+    ImpactType type;
+    float time;                     // Fraction of the step at the first contact, in [0, 1]
+    Vector2 position;               // Projectile center at the first contact
+    int target;                     // Building or player index, -1 otherwise
+} Impact;
+
+// Everything a projectile can collide with
+typedef struct CollisionWorld {
+    const Building *building;       // Sorted by x, side by side: see FindFirstBuilding()
+    int buildingCount;
+    const Explosion *explosion;     // Craters, a projectile whose center is inside one never hits a building
+    int explosionCount;
+    const Player *player;
+    int playerCount;
+    float width;
+    float height;
+} CollisionWorld;
+
+// First building whose right side is past x, count if there is none.
+// NOTE: Buildings must be sorted by x without overlapping (as generated), queries over an x range are O(log n + buildings in range)
+int FindFirstBuilding(const Building *building, int count, float x);
+
+// Swept tests: the circle center moves linearly from start (time 0) to end (time 1).
+// The returned interval is measured along the whole line, so it may extend outside [0, 1].
+bool SweptCircleRec(Vector2 start, Vector2 end, float radius, Rectangle rec, float *enter, float *exit);
+bool SweptPointCircle(Vector2 start, Vector2 end, Vector2 center, float radius, float *enter, float *exit);
+
+// First contact of a projectile moving from start to end, the shooter is never hit
+Impact SweepProjectile(const CollisionWorld *world, Vector2 start, Vector2 end, float radius, int owner);
+
+// Fly a shot until it collides, advancing ticksPerStep game ticks per swept step.
+// Positions at step boundaries are exact for any step size, returns the impact and the (fractional) tick it happened.
+Impact SimulateShot(const CollisionWorld *world, Vector2 position, Vector2 speed, float radius, int owner, int ticksPerStep, int maxTicks, float *tick);
+
+// Fly a shot tick by tick as the game does, storing the start and the center after every tick up to the first impact (included).
+// Returns the number of points, at most maxPoints: a longer flight is cut
+int TraceShot(const CollisionWorld *world, Vector2 position, Vector2 speed, float radius, int owner, Vector2 *points, int maxPoints);
+
+#endif // COLLISION_H
@@ -0,0 +1,134 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "fairness.h"
+
+#include "input.h"
+#include "jobs.h"
+#include "match.h"
+
+#include <time.h>
+
+#define FAIRNESS_ANGLES          (MAX_AIM_ANGLE/FAIRNESS_ANGLE_STEP)
+#define FAIRNESS_POWERS          (MAX_AIM_POWER/FAIRNESS_POWER_STEP)
+#define FAIRNESS_SHOTS           (FAIRNESS_ANGLES*FAIRNESS_POWERS)      // Per player
+
+typedef struct FairnessTask {
+    const Match *match;
+    CollisionWorld world;
+    double deadline;
+    int hits[MAX_PLAYERS];
+    bool stopped;
+} FairnessTask;
+
+static float fairnessThreshold = FAIRNESS_DEFAULT_THRESHOLD;
+static float fairnessBudget = FAIRNESS_DEFAULT_BUDGET;
+
+double GetFairnessTime(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec + now.tv_nsec/1000000000.0;
+}
+
+// Shots [start, end) of every player in turn, the counts of a range are added at once
+static void CountHits(void *data, int start, int end)
+{
+    FairnessTask *task = (FairnessTask *)data;
+    int hits[MAX_PLAYERS] = { 0 };
+
+    // Ranges left once the deadline passed are skipped, the result is marked incomplete
+    if (__atomic_load_n(&task->stopped, __ATOMIC_RELAXED)) return;
+
+    if (GetFairnessTime() > task->deadline)
+    {
+        __atomic_store_n(&task->stopped, true, __ATOMIC_RELAXED);
+        return;
+    }
+
+    for (int i = start; i < end; i++)
+    {
+        int shooter = i/FAIRNESS_SHOTS;
+        int shot = i%FAIRNESS_SHOTS;
+        int angle = (shot/FAIRNESS_POWERS + 1)*FAIRNESS_ANGLE_STEP;
+        int power = (shot%FAIRNESS_POWERS + 1)*FAIRNESS_POWER_STEP;
+        const Player *player = &task->match->player[shooter];
+
+        Impact impact = GetShotImpact(&task->world, player, shooter, angle, power);
+
+        if ((impact.type == IMPACT_PLAYER) && (task->match->player[impact.target].isLeftTeam != player->isLeftTeam)) hits[shooter]++;
+    }
+
+    for (int p = 0; p < MAX_PLAYERS; p++)
+    {
+        if (hits[p] > 0) __atomic_fetch_add(&task->hits[p], hits[p], __ATOMIC_RELAXED);
+    }
+}
+
+bool AnalyzeLevelFairness(const Level *level, LevelFairness *fairness, double deadline)
+{
+    Match match;
+    InitMatch(&match, level);
+
+    FairnessTask task = { &match, GetMatchWorld(&match), deadline, { 0 }, false };
+
+    ParallelFor(MAX_PLAYERS*FAIRNESS_SHOTS, FAIRNESS_GRAIN, CountHits, &task);
+
+    fairness->teamHits[0] = 0;
+    fairness->teamHits[1] = 0;
+
+    for (int p = 0; p < MAX_PLAYERS; p++)
+    {
+        fairness->hits[p] = task.hits[p];
+        fairness->teamHits[match.player[p].isLeftTeam? 0 : 1] += task.hits[p];
+    }
+
+    int fewest = (fairness->teamHits[0] < fairness->teamHits[1])? fairness->teamHits[0] : fairness->teamHits[1];
+    int most = (fairness->teamHits[0] > fairness->teamHits[1])? fairness->teamHits[0] : fairness->teamHits[1];
+
+    fairness->balance = (most > 0)? (float)fewest/most : 0.0f;
+    fairness->complete = !task.stopped;
+
+    return fairness->complete;
+}
+
+void SetLevelFairness(float threshold, float budget)
+{
+    fairnessThreshold = threshold;
+    fairnessBudget = budget;
+}
+
+void GenerateFairLevel(Level *level, unsigned int seed, int width, int height)
+{
+    Level candidate;
+    double start = GetFairnessTime();
+    double deadline = start + fairnessBudget;
+    LevelFairness best = { 0 };
+    int candidates = 0;
+
+    GenerateLevel(level, seed, width, height);
+
+    while (GetFairnessTime() < deadline)
+    {
+        LevelFairness fairness = { 0 };
+
+        GenerateLevel(&candidate, seed, width, height);
+        if (!AnalyzeLevelFairness(&candidate, &fairness, deadline)) break;
+
+        candidates++;
+
+        if (fairness.balance > best.balance)
+        {
+            *level = candidate;
+            best = fairness;
+        }
+
+        if (best.balance >= fairnessThreshold) break;
+
+        // Next candidate, same sequence for the same seed
+        seed = seed*1664525u + 1013904223u;
+    }
+
+    TraceLog((best.balance >= fairnessThreshold)? LOG_INFO : LOG_WARNING, "LEVEL: [%u] %i/%i hitting shots, balance %.2f, %i candidates in %.1f ms",
+             level->seed, best.teamHits[0], best.teamHits[1], best.balance, candidates, 1000.0*(GetFairnessTime() - start));
+}
@@ -0,0 +1,33 @@
+#ifndef FAIRNESS_H
+#define FAIRNESS_H
+
+#include "level.h"
+
+#include <stdbool.h>
+
+#define FAIRNESS_ANGLE_STEP               2        // Sampled aim grid, every other angle
+#define FAIRNESS_POWER_STEP               3        // and every third power
+#define FAIRNESS_DEFAULT_THRESHOLD     0.50f        // Fewest hitting shots of a team over the most of the other one
+#define FAIRNESS_DEFAULT_BUDGET        0.10f        // Seconds spent looking for a fair level
+#define FAIRNESS_GRAIN                   64        // Shots per parallel range
+
+// Hitting shots of every player over the sampled (angle, power) grid, on the level as generated (no craters)
+typedef struct LevelFairness {
+    int hits[MAX_PLAYERS];              // Shots hitting an opponent
+    int teamHits[2];                    // Left and right team
+    float balance;                      // Fewest team hits over the most, 0 if a team cannot hit at all
+    bool complete;                      // False if the deadline stopped the count
+} LevelFairness;
+
+// NOTE: Shots are spread over the job system with ParallelFor, the analysis may run from a job (the level queue refill)
+bool AnalyzeLevelFairness(const Level *level, LevelFairness *fairness, double deadline);     // Deadline from GetFairnessTime(), false if missed
+double GetFairnessTime(void);                                                               // Seconds, monotonic
+
+// Level generator for SetLevelGenerator(): candidates are generated from the seed until one is within the threshold.
+// Once the budget is spent the fairest complete candidate is kept, the first level if none could be analyzed.
+// NOTE: It runs on the level queue refill (a job, or the producer thread without job workers), a restart only copies its result.
+// Only a level needed while the queue is empty (the first match) is generated in place, for up to the budget
+void SetLevelFairness(float threshold, float budget);
+void GenerateFairLevel(Level *level, unsigned int seed, int width, int height);
+
+#endif // FAIRNESS_H
@@ -0,0 +1,32 @@
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include "gorilla.h"
+
+// Q16.16 fixed-point numbers for the deterministic physics mode.
+// Only integer adds, multiplies and shifts are used, so the flight gives the same positions with any compiler, flags or CPU.
+// NOTE: Collisions (clearance, sweeps, impact point, craters) stay in float, with only correctly rounded operations (+ - * / sqrtf).
+// They match between builds because the Makefile turns off FMA contraction and fast math (FP_CFLAGS), `make replay-check` verifies it.
+// A build without those flags, or x87 math (32-bit x86 without -mfpmath=sse), can land a shot elsewhere
+#define FIXED_SHIFT                      16
+#define FIXED_ONE          (1 << FIXED_SHIFT)
+#define FIXED_GRAVITY                 10715        // GRAVITY/DELTA_FPS in Q16.16, rounded once and for all
+
+// NOTE: Positions stay within +-32767 pixels, far beyond the field where projectiles are removed
+static inline int FixedFromFloat(float value)
+{
+    return (int)(value*FIXED_ONE);
+}
+
+static inline float FixedToFloat(int value)
+{
+    return (float)value*(1.0f/FIXED_ONE);
+}
+
+int FixedSin(int degrees);      // Q16.16, degrees in [0, 90] (clamped), from a precomputed table
+int FixedCos(int degrees);
+
+// Launch speed of a shot in Q16.16 pixels per tick, same formula as the float one (power*3/DELTA_FPS)
+void GetFixedShotSpeed(int angle, int power, bool leftTeam, int *speedX, int *speedY);
+
+#endif // FIXEDPOINT_H
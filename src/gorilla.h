@@ -0,0 +1,50 @@
+#ifndef GORILLA_H
+#define GORILLA_H
+
+#include "raylib.h"
+
+#define MAX_BUILDINGS                    15        // Per screen of the world
+#define MAX_WORLD_SCREENS               128        // Widest world, in screens
+#define MAX_WORLD_BUILDINGS     (MAX_BUILDINGS*MAX_WORLD_SCREENS)
+#define WORLD_SCREEN_WIDTH              800
+#define MAX_EXPLOSIONS                  200
+#define MAX_PLAYERS                       2
+
+#define PLAYER_SIZE                      40
+
+#define MAX_INPUT_CHARS                   3
+
+#define GRAVITY                       9.81f
+#define DELTA_FPS                        60
+
+typedef struct Player {
+    Vector2 position;
+    Vector2 size;
+
+    Vector2 aimingPoint;
+    int aimingAngle;
+    int aimingPower;
+
+    Vector2 previousPoint;
+    int previousAngle;
+    int previousPower;
+
+    Vector2 impactPoint;
+
+    bool isLeftTeam;                // This player belongs to the left or to the right team
+    bool isPlayer;                  // If is a player or an AI
+    bool isAlive;
+} Player;
+
+typedef struct Building {
+    Rectangle rectangle;
+    Color color;
+} Building;
+
+typedef struct Explosion {
+    Vector2 position;
+    int radius;
+    bool active;
+} Explosion;
+
+#endif // GORILLA_H
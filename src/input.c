@@ -0,0 +1,44 @@
+#include "input.h"
+
+bool PushInputEvent(InputQueue *queue, InputEventType type, int value, double time)
+{
+    if (queue->eventCount >= MAX_INPUT_EVENTS) return false;
+
+    queue->event[queue->eventCount] = (InputEvent){ type, value, time };
+    queue->eventCount++;
+
+    return true;
+}
+
+bool PushAimDigit(AimField *field, int digit)
+{
+    if ((field->length >= MAX_INPUT_CHARS) || (digit < 0) || (digit > 9)) return false;
+
+    field->text[field->length] = (char)('0' + digit);
+    field->text[field->length + 1] = '\0';
+    field->length++;
+    field->value = field->value*10 + digit;
+
+    return true;
+}
+
+bool PopAimDigit(AimField *field)
+{
+    if (field->length == 0) return false;
+
+    field->length--;
+    field->text[field->length] = '\0';
+    field->value /= 10;
+
+    return true;
+}
+
+void ClearAimInput(AimInput *aim)
+{
+    *aim = (AimInput){ 0 };
+}
+
+bool IsAimValid(const AimInput *aim)
+{
+    return (aim->power.value > 0) && (aim->power.value <= MAX_AIM_POWER) && (aim->angle.value > 0) && (aim->angle.value <= MAX_AIM_ANGLE);
+}
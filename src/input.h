@@ -0,0 +1,53 @@
+#ifndef INPUT_H
+#define INPUT_H
+
+#include "gorilla.h"
+
+#define MAX_INPUT_EVENTS                 64        // Events buffered between two simulation ticks
+#define MAX_AIM_POWER                   300
+#define MAX_AIM_ANGLE                    90
+
+typedef enum {
+    INPUT_DIGIT = 0,                // Digit typed in the text box under the mouse, in value
+    INPUT_BACKSPACE,
+    INPUT_FIRE,                     // Fire, or restart once the game is over
+    INPUT_PAUSE,
+    INPUT_SAVE,
+    INPUT_LOAD
+} InputEventType;
+
+typedef struct InputEvent {
+    InputEventType type;
+    int value;                      // 0..9 for INPUT_DIGIT
+    double time;                    // GetTime() when the event was sampled
+} InputEvent;
+
+// Events sampled since the last simulation tick, in order
+typedef struct InputQueue {
+    unsigned int sequence;          // Changes whenever something was sampled
+    Vector2 mousePosition;
+    float frameTime;                // Seconds, last render frame when sampled
+    InputEvent event[MAX_INPUT_EVENTS];
+    int eventCount;
+} InputQueue;
+
+// Text box value, parsed once per keystroke so nobody has to parse the text again
+typedef struct AimField {
+    int value;
+    int length;
+    char text[MAX_INPUT_CHARS + 1];
+} AimField;
+
+// Validated aim of the current turn, what AI, replays and the network exchange instead of text
+typedef struct AimInput {
+    AimField power;
+    AimField angle;
+} AimInput;
+
+bool PushInputEvent(InputQueue *queue, InputEventType type, int value, double time);    // False once the queue is full
+bool PushAimDigit(AimField *field, int digit);  // False if the field is full
+bool PopAimDigit(AimField *field);              // False if the field is empty
+void ClearAimInput(AimInput *aim);
+bool IsAimValid(const AimInput *aim);           // Power and angle in range, the shot can be fired
+
+#endif // INPUT_H
@@ -0,0 +1,423 @@
+#define _GNU_SOURCE     // pthread_setaffinity_np()
+
+#include "jobs.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #include <sched.h>
+    #include <unistd.h>
+    #define JOB_SYSTEM_THREADED
+#endif
+
+#define JOB_DEQUE_MASK      (JOB_DEQUE_SIZE - 1)
+
+// Chase-Lev deque: the owner pushes and pops at the bottom, thieves steal at the top
+typedef struct JobDeque {
+    long top;
+    long bottom;
+    Job *job[JOB_DEQUE_SIZE];
+} JobDeque;
+
+// Jobs submitted by threads that are not workers, stolen like the deques
+typedef struct JobQueue {
+    int head;
+    int count;
+    Job *job[JOB_DEQUE_SIZE];
+} JobQueue;
+
+typedef struct ParallelForTask {
+    JobRangeFunction function;
+    void *data;
+    int count;
+    int grain;
+    int start;          // Next range to run, shared by every helper
+} ParallelForTask;
+
+static int workerCount = 0;
+
+#if defined(JOB_SYSTEM_THREADED)
+static JobDeque deque[MAX_JOB_WORKERS] = { 0 };
+static pthread_t worker[MAX_JOB_WORKERS];
+static bool pinned = false;
+static bool running = false;
+
+static JobQueue submitted = { 0 };
+static pthread_mutex_t submittedMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// NOTE: A worker only sleeps while nothing is queued, queuedJobs and sleepingWorkers are
+// updated in opposite order by both sides so a wake up is never lost
+static int queuedJobs = 0;
+static int sleepingWorkers = 0;
+static pthread_mutex_t sleepMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t jobQueued = PTHREAD_COND_INITIALIZER;
+
+static __thread int workerIndex = -1;      // Worker running on this thread, -1 for other threads
+
+//----------------------------------------------------------------------------------
+// Deques
+//----------------------------------------------------------------------------------
+static bool PushDeque(JobDeque *deque, Job *job)
+{
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+
+    if (bottom - top >= JOB_DEQUE_SIZE) return false;
+
+    __atomic_store_n(&deque->job[bottom & JOB_DEQUE_MASK], job, __ATOMIC_RELAXED);
+    __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+static Job *PopDeque(JobDeque *deque)
+{
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_RELAXED) - 1;
+    __atomic_store_n(&deque->bottom, bottom, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long top = __atomic_load_n(&deque->top, __ATOMIC_RELAXED);
+
+    Job *job = NULL;
+
+    if (top <= bottom)
+    {
+        job = __atomic_load_n(&deque->job[bottom & JOB_DEQUE_MASK], __ATOMIC_RELAXED);
+
+        // Last job: race the thieves for it
+        if (top == bottom)
+        {
+            if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) job = NULL;
+            __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+        }
+    }
+    else __atomic_store_n(&deque->bottom, bottom + 1, __ATOMIC_RELAXED);
+
+    return job;
+}
+
+static Job *StealDeque(JobDeque *deque)
+{
+    long top = __atomic_load_n(&deque->top, __ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    long bottom = __atomic_load_n(&deque->bottom, __ATOMIC_ACQUIRE);
+
+    if (top >= bottom) return NULL;
+
+    Job *job = __atomic_load_n(&deque->job[top & JOB_DEQUE_MASK], __ATOMIC_RELAXED);
+
+    // Another thief or the owner took it first
+    if (!__atomic_compare_exchange_n(&deque->top, &top, top + 1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)) return NULL;
+
+    return job;
+}
+
+static bool PushSubmitted(Job *job)
+{
+    bool pushed = false;
+
+    pthread_mutex_lock(&submittedMutex);
+
+    if (submitted.count < JOB_DEQUE_SIZE)
+    {
+        submitted.job[(submitted.head + submitted.count) & JOB_DEQUE_MASK] = job;
+        __atomic_store_n(&submitted.count, submitted.count + 1, __ATOMIC_RELAXED);
+        pushed = true;
+    }
+
+    pthread_mutex_unlock(&submittedMutex);
+
+    return pushed;
+}
+
+static Job *PopSubmitted(void)
+{
+    Job *job = NULL;
+
+    // Cheap check first, the lock is only taken when something may be there
+    if (__atomic_load_n(&submitted.count, __ATOMIC_RELAXED) == 0) return NULL;
+
+    pthread_mutex_lock(&submittedMutex);
+
+    if (submitted.count > 0)
+    {
+        job = submitted.job[submitted.head];
+        submitted.head = (submitted.head + 1) & JOB_DEQUE_MASK;
+        __atomic_store_n(&submitted.count, submitted.count - 1, __ATOMIC_RELAXED);
+    }
+
+    pthread_mutex_unlock(&submittedMutex);
+
+    return job;
+}
+
+// Own deque first (most recent job, still in cache), then the oldest jobs of the others
+static Job *FindJob(void)
+{
+    Job *job = NULL;
+
+    if (workerIndex >= 0) job = PopDeque(&deque[workerIndex]);
+    if (job == NULL) job = PopSubmitted();
+
+    int first = (workerIndex >= 0)? workerIndex + 1 : 0;
+
+    for (int i = 0; (job == NULL) && (i < workerCount); i++) job = StealDeque(&deque[(first + i)%workerCount]);
+
+    if (job != NULL) __atomic_sub_fetch(&queuedJobs, 1, __ATOMIC_SEQ_CST);
+
+    return job;
+}
+#endif
+
+//----------------------------------------------------------------------------------
+// Jobs
+//----------------------------------------------------------------------------------
+static void QueueJob(Job *job);
+
+static void FinishJob(Job *job)
+{
+    // NOTE: Once unfinished reaches 0 the owner may release the job, read it before
+    Job *parent = job->parent;
+    Job *next[MAX_JOB_CONTINUATIONS];
+    int nextCount = job->nextCount;
+
+    memcpy(next, job->next, nextCount*sizeof(Job *));
+
+    if (__atomic_sub_fetch(&job->unfinished, 1, __ATOMIC_ACQ_REL) > 0) return;
+
+    for (int i = 0; i < nextCount; i++)
+    {
+        if (__atomic_sub_fetch(&next[i]->dependencies, 1, __ATOMIC_ACQ_REL) == 0) QueueJob(next[i]);
+    }
+
+    if (parent != NULL) FinishJob(parent);
+}
+
+static void RunJob(Job *job)
+{
+    if (job->function != NULL) job->function(job->data);
+
+    FinishJob(job);
+}
+
+static void QueueJob(Job *job)
+{
+#if defined(JOB_SYSTEM_THREADED)
+    if (workerCount > 0)
+    {
+        __atomic_add_fetch(&queuedJobs, 1, __ATOMIC_SEQ_CST);
+
+        bool pushed = (workerIndex >= 0)? PushDeque(&deque[workerIndex], job) : PushSubmitted(job);
+
+        if (pushed)
+        {
+            if (__atomic_load_n(&sleepingWorkers, __ATOMIC_SEQ_CST) > 0)
+            {
+                pthread_mutex_lock(&sleepMutex);
+                pthread_cond_signal(&jobQueued);
+                pthread_mutex_unlock(&sleepMutex);
+            }
+
+            return;
+        }
+
+        // Queue full: run it right away
+        __atomic_sub_fetch(&queuedJobs, 1, __ATOMIC_SEQ_CST);
+    }
+#endif
+
+    RunJob(job);
+}
+
+#if defined(JOB_SYSTEM_THREADED)
+static void *JobWorker(void *data)
+{
+    workerIndex = (int)(intptr_t)data;
+
+    pthread_mutex_lock(&sleepMutex);
+    pthread_mutex_unlock(&sleepMutex);
+
+    // Worker i on core i + 1, the core of the main thread is left alone
+    if (pinned)
+    {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET((workerIndex + 1)%GetCpuCount(), &cpus);
+        pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    }
+
+    while (true)
+    {
+        Job *job = FindJob();
+
+        if (job != NULL)
+        {
+            RunJob(job);
+            continue;
+        }
+
+        pthread_mutex_lock(&sleepMutex);
+        __atomic_add_fetch(&sleepingWorkers, 1, __ATOMIC_SEQ_CST);
+
+        while (running && (__atomic_load_n(&queuedJobs, __ATOMIC_SEQ_CST) == 0)) pthread_cond_wait(&jobQueued, &sleepMutex);
+
+        __atomic_sub_fetch(&sleepingWorkers, 1, __ATOMIC_SEQ_CST);
+        bool stop = !running && (__atomic_load_n(&queuedJobs, __ATOMIC_SEQ_CST) == 0);
+        pthread_mutex_unlock(&sleepMutex);
+
+        if (stop) break;
+    }
+
+    return NULL;
+}
+#endif
+
+void InitJobSystem(int count, bool pinWorkers)
+{
+    if (count < 0) count = GetCpuCount() - 1;
+    if (count > MAX_JOB_WORKERS) count = MAX_JOB_WORKERS;
+
+    workerCount = 0;
+
+#if defined(JOB_SYSTEM_THREADED)
+    int created = 0;
+
+    // NOTE: The workers wait for the lock before they start, workerCount is final by then
+    pthread_mutex_lock(&sleepMutex);
+    pinned = pinWorkers;
+    running = true;
+
+    // Without workers the jobs still work, they just run in place
+    for (int i = 0; i < count; i++)
+    {
+        deque[i].top = 0;
+        deque[i].bottom = 0;
+
+        if (pthread_create(&worker[i], NULL, JobWorker, (void *)(intptr_t)i) != 0) break;
+        created++;
+    }
+
+    workerCount = created;
+    pthread_mutex_unlock(&sleepMutex);
+#else
+    (void)count;
+    (void)pinWorkers;
+#endif
+}
+
+void CloseJobSystem(void)
+{
+#if defined(JOB_SYSTEM_THREADED)
+    pthread_mutex_lock(&sleepMutex);
+    running = false;
+    pthread_cond_broadcast(&jobQueued);
+    pthread_mutex_unlock(&sleepMutex);
+
+    for (int i = 0; i < workerCount; i++) pthread_join(worker[i], NULL);
+#endif
+
+    workerCount = 0;
+}
+
+int GetJobWorkerCount(void)
+{
+    return workerCount;
+}
+
+int GetCpuCount(void)
+{
+#if defined(JOB_SYSTEM_THREADED)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return (count > 0)? (int)count : 1;
+#else
+    return 1;
+#endif
+}
+
+void InitJob(Job *job, JobFunction function, void *data, Job *parent)
+{
+    job->function = function;
+    job->data = data;
+    job->parent = parent;
+    job->nextCount = 0;
+    job->unfinished = 1;
+    job->dependencies = 1;
+
+    if (parent != NULL) __atomic_add_fetch(&parent->unfinished, 1, __ATOMIC_RELAXED);
+}
+
+bool AddJobDependency(Job *job, Job *dependency)
+{
+    // NOTE: Without room for the continuation the job could run first, the caller has to order them some other way
+    if (dependency->nextCount == MAX_JOB_CONTINUATIONS) return false;
+
+    dependency->next[dependency->nextCount++] = job;
+    job->dependencies++;
+
+    return true;
+}
+
+void SubmitJob(Job *job)
+{
+    if (__atomic_sub_fetch(&job->dependencies, 1, __ATOMIC_ACQ_REL) == 0) QueueJob(job);
+}
+
+void WaitJob(Job *job)
+{
+    while (!IsJobDone(job))
+    {
+#if defined(JOB_SYSTEM_THREADED)
+        Job *other = FindJob();
+
+        if (other != NULL) RunJob(other);
+        else sched_yield();
+#endif
+    }
+}
+
+bool IsJobDone(const Job *job)
+{
+    return (__atomic_load_n(&job->unfinished, __ATOMIC_ACQUIRE) == 0);
+}
+
+static void RunRanges(void *data)
+{
+    ParallelForTask *task = (ParallelForTask *)data;
+
+    while (true)
+    {
+        int start = __atomic_fetch_add(&task->start, task->grain, __ATOMIC_RELAXED);
+        if (start >= task->count) break;
+
+        int end = start + task->grain;
+        if (end > task->count) end = task->count;
+
+        task->function(task->data, start, end);
+    }
+}
+
+void ParallelFor(int count, int grain, JobRangeFunction function, void *data)
+{
+    if (count <= 0) return;
+    if (grain < 1) grain = 1;
+
+    ParallelForTask task = { function, data, count, grain, 0 };
+    Job helper[MAX_JOB_WORKERS];
+
+    // One helper per worker at most, ranges are handed out dynamically so uneven ones balance out
+    int ranges = (count + grain - 1)/grain;
+    int helpers = (workerCount < ranges - 1)? workerCount : ranges - 1;
+
+    for (int i = 0; i < helpers; i++)
+    {
+        InitJob(&helper[i], RunRanges, &task, NULL);
+        SubmitJob(&helper[i]);
+    }
+
+    RunRanges(&task);
+
+    for (int i = 0; i < helpers; i++) WaitJob(&helper[i]);
+}
@@ -0,0 +1,41 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <stdbool.h>
+
+#define MAX_JOB_WORKERS                  64        // Worker threads, the threads waiting for jobs help on top of them
+#define MAX_JOB_CONTINUATIONS             8        // Jobs that can depend on a single job
+#define JOB_DEQUE_SIZE                 1024        // Jobs queued per worker, power of two
+
+typedef void (*JobFunction)(void *data);
+typedef void (*JobRangeFunction)(void *data, int start, int end);
+
+// A job is owned by the caller and must stay alive until it is done (WaitJob() or IsJobDone()).
+// A job is done once its function returned and all of its children are done.
+typedef struct Job {
+    JobFunction function;
+    void *data;
+    struct Job *parent;                             // Not done until this job is done, NULL for none
+    struct Job *next[MAX_JOB_CONTINUATIONS];        // Jobs waiting for this one to be done
+    int nextCount;
+    int unfinished;                                 // This job and its children not done yet
+    int dependencies;                               // Jobs to be done before this one can run, plus the submission
+} Job;
+
+// Job system: one work-stealing deque per worker, idle workers steal from the others.
+// NOTE: Every subsystem shares these workers, none of them should spawn its own threads for parallel work
+void InitJobSystem(int workerCount, bool pinWorkers);   // workerCount < 0 uses every core but the calling one
+void CloseJobSystem(void);                              // Runs the jobs still queued, then stops the workers
+int GetJobWorkerCount(void);
+int GetCpuCount(void);
+
+void InitJob(Job *job, JobFunction function, void *data, Job *parent);
+bool AddJobDependency(Job *job, Job *dependency);       // Both jobs must not be submitted yet, fails once dependency has MAX_JOB_CONTINUATIONS
+void SubmitJob(Job *job);                               // Queued once all of its dependencies are done, run in place without workers
+void WaitJob(Job *job);                                 // Runs other jobs while waiting
+bool IsJobDone(const Job *job);
+
+// Call function over [0, count) split in ranges of grain indices, returns once every range is done
+void ParallelFor(int count, int grain, JobRangeFunction function, void *data);
+
+#endif // JOBS_H
@@ -0,0 +1,104 @@
+#include "latency.h"
+
+#include "raylib.h"
+
+#include <string.h>
+
+#define LATENCY_LOG_BUCKETS              16        // Buckets merged per distribution line (4 ms)
+#define LATENCY_LOG_BAR_WIDTH            40
+
+void ResetLatencyHistogram(LatencyHistogram *histogram)
+{
+    memset(histogram, 0, sizeof(LatencyHistogram));
+}
+
+void AddLatencySample(LatencyHistogram *histogram, double seconds)
+{
+    if (seconds < 0.0) seconds = 0.0;
+
+    int index = (int)(seconds*1000.0/LATENCY_BUCKET_MS);
+    if (index >= LATENCY_BUCKETS) index = LATENCY_BUCKETS - 1;
+
+    histogram->bucket[index]++;
+
+    if ((histogram->count == 0) || (seconds < histogram->min)) histogram->min = seconds;
+    if ((histogram->count == 0) || (seconds > histogram->max)) histogram->max = seconds;
+
+    histogram->count++;
+    histogram->total += seconds;
+}
+
+// Upper bound of the bucket holding the percentile, clamped to the samples range
+double GetLatencyPercentile(const LatencyHistogram *histogram, float percentile)
+{
+    if (histogram->count == 0) return 0.0;
+
+    int rank = (int)(percentile/100.0f*histogram->count + 0.5f);
+    if (rank < 1) rank = 1;
+    if (rank > histogram->count) rank = histogram->count;
+
+    int seen = 0;
+    double value = histogram->max;
+
+    for (int i = 0; i < LATENCY_BUCKETS; i++)
+    {
+        seen += histogram->bucket[i];
+
+        if (seen >= rank)
+        {
+            value = (i + 1)*LATENCY_BUCKET_MS/1000.0;
+            break;
+        }
+    }
+
+    if (value > histogram->max) value = histogram->max;
+    if (value < histogram->min) value = histogram->min;
+
+    return value;
+}
+
+void LogLatencyHistogram(const LatencyHistogram *histogram, const char *name)
+{
+    if (histogram->count == 0)
+    {
+        TraceLog(LOG_INFO, "LATENCY: %s: no samples", name);
+        return;
+    }
+
+    TraceLog(LOG_INFO, "LATENCY: %s: %i samples, min %.2f ms, mean %.2f ms, p50 %.2f ms, p90 %.2f ms, p99 %.2f ms, max %.2f ms", name, histogram->count,
+             1000.0*histogram->min, 1000.0*histogram->total/histogram->count, 1000.0*GetLatencyPercentile(histogram, 50.0f),
+             1000.0*GetLatencyPercentile(histogram, 90.0f), 1000.0*GetLatencyPercentile(histogram, 99.0f), 1000.0*histogram->max);
+
+    // Distribution, in coarser buckets, from the first to the last non-empty one
+    int largest = 0;
+    int first = -1;
+    int last = 0;
+
+    for (int i = 0; i < LATENCY_BUCKETS; i += LATENCY_LOG_BUCKETS)
+    {
+        int count = 0;
+        for (int j = i; (j < i + LATENCY_LOG_BUCKETS) && (j < LATENCY_BUCKETS); j++) count += histogram->bucket[j];
+
+        if (count > 0)
+        {
+            if (first < 0) first = i;
+            last = i;
+        }
+
+        if (count > largest) largest = count;
+    }
+
+    for (int i = first; i <= last; i += LATENCY_LOG_BUCKETS)
+    {
+        int count = 0;
+        for (int j = i; (j < i + LATENCY_LOG_BUCKETS) && (j < LATENCY_BUCKETS); j++) count += histogram->bucket[j];
+
+        char bar[LATENCY_LOG_BAR_WIDTH + 1] = { 0 };
+        int width = count*LATENCY_LOG_BAR_WIDTH/largest;
+        if ((count > 0) && (width == 0)) width = 1;
+
+        memset(bar, '#', width);
+
+        TraceLog(LOG_INFO, "LATENCY:   %6.1f - %6.1f ms %6i %s", i*LATENCY_BUCKET_MS, (i + LATENCY_LOG_BUCKETS)*LATENCY_BUCKET_MS, count, bar);
+    }
+}
@@ -0,0 +1,21 @@
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#define LATENCY_BUCKET_MS             0.25f        // Histogram resolution
+#define LATENCY_BUCKETS                 800        // Up to 200 ms, slower samples go to the last bucket
+
+// Fixed-size latency histogram, adding a sample never allocates
+typedef struct LatencyHistogram {
+    int bucket[LATENCY_BUCKETS];
+    int count;
+    double total;                   // Seconds
+    double min;
+    double max;
+} LatencyHistogram;
+
+void ResetLatencyHistogram(LatencyHistogram *histogram);
+void AddLatencySample(LatencyHistogram *histogram, double seconds);
+double GetLatencyPercentile(const LatencyHistogram *histogram, float percentile);    // Seconds, percentile in [0, 100]
+void LogLatencyHistogram(const LatencyHistogram *histogram, const char *name);        // Summary and distribution, with TraceLog()
+
+#endif // LATENCY_H
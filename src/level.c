@@ -0,0 +1,284 @@
+#include "level.h"
+#include "collision.h"
+#include "jobs.h"
+#include "rng.h"
+
+#include <stddef.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #define LEVEL_QUEUE_THREADED
+#endif
+
+#define BUILDING_RELATIVE_ERROR          30        // Building size random range %
+#define BUILDING_MIN_RELATIVE_HEIGHT     20        // Minimum height in % of the screenHeight
+#define BUILDING_MAX_RELATIVE_HEIGHT     80        // Maximum height in % of the screenHeight
+#define BUILDING_MIN_GRAYSCALE_COLOR    50        // Minimum gray color for the buildings
+#define BUILDING_MAX_GRAYSCALE_COLOR    130        // Maximum gray color for the buildings
+
+#define MIN_PLAYER_POSITION               5        // Minimum x position %
+#define MAX_PLAYER_POSITION              20        // Maximum x position %
+
+static Level queue[LEVEL_QUEUE_SIZE] = { 0 };
+static int queueHead = 0;
+static int queueCount = 0;
+static unsigned int nextSeed = 0;
+static int levelWidth = 0;
+static int levelHeight = 0;
+static LevelGenerator generator = GenerateLevel;
+
+static bool queueOpen = false;
+static Job refillJob = { 0 };           // Done while no refill is queued or running
+
+#if defined(LEVEL_QUEUE_THREADED)
+static pthread_mutex_t queueMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// NOTE: Without job workers a submitted job runs in place, on the thread restarting the match.
+// The refill gets its own producer thread then, so a restart still only copies a level
+static pthread_t producer;
+static pthread_cond_t refillRequested = PTHREAD_COND_INITIALIZER;
+static bool producerRunning = false;
+#endif
+
+static void GenerateBuildings(Level *level, unsigned int *state)
+{
+    // Horizontal generation
+    int currentWidth = 0;
+
+    int screens = (level->width + WORLD_SCREEN_WIDTH/2)/WORLD_SCREEN_WIDTH;
+    if (screens < 1) screens = 1;
+    if (screens > MAX_WORLD_SCREENS) screens = MAX_WORLD_SCREENS;
+
+    level->buildingCount = MAX_BUILDINGS*screens;
+
+    float relativeWidth = 100/(100 - BUILDING_RELATIVE_ERROR);
+    float buildingWidthMean = (level->width*relativeWidth/level->buildingCount) + 1;       // We add one to make sure we will cover the whole screen.
+
+    // Vertical generation
+    int currentHeighth = 0;
+    int grayLevel;
+
+    // Creation
+    for (int i = 0; i < level->buildingCount; i++)
+    {
+        Building *building = &level->building[i];
+
+        // Horizontal
+        building->rectangle.x = currentWidth;
+        building->rectangle.width = RandomRange(state, buildingWidthMean*(100 - BUILDING_RELATIVE_ERROR/2)/100 + 1, buildingWidthMean*(100 + BUILDING_RELATIVE_ERROR)/100);
+
+        currentWidth += building->rectangle.width;
+
+        // Vertical
+        currentHeighth = RandomRange(state, BUILDING_MIN_RELATIVE_HEIGHT, BUILDING_MAX_RELATIVE_HEIGHT);
+        building->rectangle.y = level->height - (level->height*currentHeighth/100);
+        building->rectangle.height = level->height*currentHeighth/100 + 1;
+
+        // Color
+        grayLevel = RandomRange(state, BUILDING_MIN_GRAYSCALE_COLOR, BUILDING_MAX_GRAYSCALE_COLOR);
+        building->color = (Color){ grayLevel, grayLevel, grayLevel, 255 };
+    }
+}
+
+static void GeneratePlayerPositions(Level *level, unsigned int *state)
+{
+    // Battle span, the whole level when it fits
+    int battleWidth = level->width;
+    int battleStart = 0;
+
+    if (battleWidth > LEVEL_BATTLE_WIDTH)
+    {
+        battleWidth = LEVEL_BATTLE_WIDTH;
+        battleStart = RandomRange(state, 0, level->width - battleWidth);
+    }
+
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        Vector2 *position = &level->playerPosition[i];
+
+        // Even players are on the left team, odd ones on the right
+        if (i%2 == 0) position->x = battleStart + RandomRange(state, battleWidth*MIN_PLAYER_POSITION/100, battleWidth*MAX_PLAYER_POSITION/100);
+        else position->x = battleStart + battleWidth - RandomRange(state, battleWidth*MIN_PLAYER_POSITION/100, battleWidth*MAX_PLAYER_POSITION/100);
+
+        // Building under that position
+        int target = FindFirstBuilding(level->building, level->buildingCount, position->x);
+        if (target > level->buildingCount - 1) target = level->buildingCount - 1;
+
+        // Set the player in the center of the building, at the top of it
+        position->x = level->building[target].rectangle.x + level->building[target].rectangle.width/2;
+        position->y = level->building[target].rectangle.y - PLAYER_SIZE/2;
+    }
+}
+
+void GenerateLevel(Level *level, unsigned int seed, int width, int height)
+{
+    unsigned int state = SeedRandom(seed);
+
+    level->seed = seed;
+    level->width = width;
+    level->height = height;
+
+    GenerateBuildings(level, &state);
+    GeneratePlayerPositions(level, &state);
+}
+
+// NOTE: Must be called with the queue locked
+static unsigned int TakeSeed(void)
+{
+    unsigned int seed = nextSeed;
+    nextSeed = nextSeed*1664525u + 1013904223u;
+
+    return seed;
+}
+
+// Job: generate levels until the queue is full
+static void RefillLevelQueue(void *data)
+{
+    (void)data;
+
+#if defined(LEVEL_QUEUE_THREADED)
+    pthread_mutex_lock(&queueMutex);
+#endif
+
+    while (queueOpen && (queueCount < LEVEL_QUEUE_SIZE))
+    {
+        unsigned int seed = TakeSeed();
+        Level level;
+
+        // Generate without holding the lock, restarts never wait for a level in progress
+#if defined(LEVEL_QUEUE_THREADED)
+        pthread_mutex_unlock(&queueMutex);
+#endif
+        generator(&level, seed, levelWidth, levelHeight);
+#if defined(LEVEL_QUEUE_THREADED)
+        pthread_mutex_lock(&queueMutex);
+#endif
+
+        if (queueCount < LEVEL_QUEUE_SIZE)
+        {
+            queue[(queueHead + queueCount)%LEVEL_QUEUE_SIZE] = level;
+            queueCount++;
+        }
+    }
+
+#if defined(LEVEL_QUEUE_THREADED)
+    pthread_mutex_unlock(&queueMutex);
+#endif
+}
+
+#if defined(LEVEL_QUEUE_THREADED)
+// Producer thread: refill whenever a level was taken, until the queue is closed
+static void *LevelProducer(void *data)
+{
+    (void)data;
+
+    pthread_mutex_lock(&queueMutex);
+
+    while (queueOpen)
+    {
+        if (queueCount < LEVEL_QUEUE_SIZE)
+        {
+            pthread_mutex_unlock(&queueMutex);
+            RefillLevelQueue(NULL);
+            pthread_mutex_lock(&queueMutex);
+        }
+        else pthread_cond_wait(&refillRequested, &queueMutex);
+    }
+
+    pthread_mutex_unlock(&queueMutex);
+
+    return NULL;
+}
+#endif
+
+// NOTE: Must be called without the queue locked
+static void RequestRefill(void)
+{
+#if defined(LEVEL_QUEUE_THREADED)
+    if (producerRunning)
+    {
+        pthread_mutex_lock(&queueMutex);
+        pthread_cond_signal(&refillRequested);
+        pthread_mutex_unlock(&queueMutex);
+        return;
+    }
+#endif
+
+    // NOTE: On the web there are no threads, the refill runs in place
+    if (!IsJobDone(&refillJob)) return;
+
+    InitJob(&refillJob, RefillLevelQueue, NULL, NULL);
+    SubmitJob(&refillJob);
+}
+
+void SetLevelGenerator(LevelGenerator levelGenerator)
+{
+    generator = (levelGenerator != NULL)? levelGenerator : GenerateLevel;
+}
+
+void InitLevelQueue(unsigned int seed, int width, int height)
+{
+    nextSeed = seed;
+    levelWidth = width;
+    levelHeight = height;
+    queueHead = 0;
+    queueCount = 0;
+    queueOpen = true;
+
+#if defined(LEVEL_QUEUE_THREADED)
+    if ((GetJobWorkerCount() == 0) && !producerRunning) producerRunning = (pthread_create(&producer, NULL, LevelProducer, NULL) == 0);
+#endif
+
+    RequestRefill();
+}
+
+void GetNextLevel(Level *level)
+{
+#if defined(LEVEL_QUEUE_THREADED)
+    pthread_mutex_lock(&queueMutex);
+#endif
+
+    if (queueCount > 0)
+    {
+        *level = queue[queueHead];
+        queueHead = (queueHead + 1)%LEVEL_QUEUE_SIZE;
+        queueCount--;
+
+#if defined(LEVEL_QUEUE_THREADED)
+        pthread_mutex_unlock(&queueMutex);
+#endif
+    }
+    else
+    {
+        unsigned int seed = TakeSeed();
+
+#if defined(LEVEL_QUEUE_THREADED)
+        pthread_mutex_unlock(&queueMutex);
+#endif
+        generator(level, seed, levelWidth, levelHeight);
+    }
+
+    RequestRefill();
+}
+
+void CloseLevelQueue(void)
+{
+#if defined(LEVEL_QUEUE_THREADED)
+    pthread_mutex_lock(&queueMutex);
+#endif
+
+    queueOpen = false;
+
+#if defined(LEVEL_QUEUE_THREADED)
+    pthread_cond_signal(&refillRequested);
+    pthread_mutex_unlock(&queueMutex);
+
+    if (producerRunning)
+    {
+        pthread_join(producer, NULL);
+        producerRunning = false;
+    }
+#endif
+
+    WaitJob(&refillJob);
+}
@@ -0,0 +1,30 @@
+#ifndef LEVEL_H
+#define LEVEL_H
+
+#include "gorilla.h"
+
+#define LEVEL_QUEUE_SIZE                  4        // Levels kept ready by the generator thread
+#define LEVEL_BATTLE_WIDTH             1200        // Span both teams stand in, every shot can still reach the other side
+
+// Everything InitGame() needs to start a match, generated from a single seed
+typedef struct Level {
+    unsigned int seed;
+    int width;
+    int height;
+    Vector2 playerPosition[MAX_PLAYERS];    // Center of each player, standing on a roof
+    int buildingCount;                      // MAX_BUILDINGS per screen of width
+    Building building[MAX_WORLD_BUILDINGS]; // Side by side from x = 0, sorted by x. Last, only the used ones are written
+} Level;
+
+// NOTE: Worlds wider than a screen keep both teams within LEVEL_BATTLE_WIDTH, somewhere along the buildings
+void GenerateLevel(Level *level, unsigned int seed, int width, int height);    // Deterministic and thread safe
+
+typedef void (*LevelGenerator)(Level *level, unsigned int seed, int width, int height);
+
+// Level queue, refilled by a background job (a producer thread without job workers) so a restart only has to copy the next level
+void SetLevelGenerator(LevelGenerator generator);  // GenerateLevel() by default, set before InitLevelQueue()
+void InitLevelQueue(unsigned int seed, int width, int height);
+void GetNextLevel(Level *level);                // Never blocks: generates in place if the queue is empty
+void CloseLevelQueue(void);
+
+#endif // LEVEL_H
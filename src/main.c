@@ -1,5 +1,27 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "raylib.h"
 
+#include "gorilla.h"
+#include "alloccheck.h"
+#include "arena.h"
+#include "botplayer.h"
+#include "collision.h"
+#include "fairness.h"
+#include "fixedpoint.h"
+#include "input.h"
+#include "latency.h"
+#include "level.h"
+#include "match.h"
+#include "jobs.h"
+#include "terrain.h"
+#include "projectile.h"
+#include "particles.h"
+#include "snapshot.h"
+#include "telemetry.h"
+#include "textcache.h"
+#include "triplebuffer.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,81 +30,167 @@
 
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
+#else
+    #include <pthread.h>
+    #define SIMULATION_THREADED
 #endif
 
-#define MAX_BUILDINGS                    15
-#define MAX_EXPLOSIONS                  200
-#define MAX_PLAYERS                       2
-
-#define BUILDING_RELATIVE_ERROR          30        // Building size random range %
-#define BUILDING_MIN_RELATIVE_HEIGHT     20        // Minimum height in % of the screenHeight
-#define BUILDING_MAX_RELATIVE_HEIGHT     80        // Maximum height in % of the screenHeight
-#define BUILDING_MIN_GRAYSCALE_COLOR    50        // Minimum gray color for the buildings
-#define BUILDING_MAX_GRAYSCALE_COLOR    130        // Maximum gray color for the buildings
-
-#define MIN_PLAYER_POSITION               5        // Minimum x position %
-#define MAX_PLAYER_POSITION              20        // Maximum x position %
+#define CURSOR_BLINK_FRAMES              20        // Frames per cursor blink phase
+#define CURSOR_IDLE_FRAMES              300        // Frames without input before the cursor stops blinking
 
-#define GRAVITY                       9.81f
-#define DELTA_FPS                        60
+#define EXPLOSION_DEBRIS_PARTICLES     4096        // Debris particles emitted by each explosion
+#define EXPLOSION_SMOKE_PARTICLES      2048        // Smoke particles emitted by each explosion
 
-#define MAX_INPUT_CHARS                   3
-
-#define PLAYER1COLOR CLITERAL(Color){163,105,35,255}
-#define PLAYER2COLOR CLITERAL(Color){249,191,48,255}
+#define MIN_RENDER_SCALE              0.25f        // Lowest internal resolution, relative to the window area used by the game
+#define MAX_RENDER_SCALE              2.00f        // Highest internal resolution (supersampling)
 
-typedef struct Player {
-    Vector2 position;
-    Vector2 size;
+#define MAX_EXPLOSION_EVENTS             64        // Recent explosions kept in the published state, for the particles
+#define MAX_FRAME_TIME                0.10f        // Longest particle step after a render stall
+#define MAX_SIMULATION_LAG               15        // Ticks behind schedule before the simulation skips ahead
 
-    Vector2 aimingPoint;
-    int aimingAngle;
-    int aimingPower;
+#define MATCH_ARENA_SIZE         (256*1024)        // Per-match buffers besides the terrain samples, released at once by InitGame()
 
-    Vector2 previousPoint;
-    int previousAngle;
-    int previousPower;
+#define CAMERA_FOLLOW_RATE            6.00f        // Fraction of the distance to its target the camera covers per second
+#define PREVIEW_MAX_POINTS             1024        // Ticks of the predicted path of the aim, a longer flight is cut
 
-    Vector2 impactPoint;
+#define SNAPSHOT_FILE_NAME     "gorilla.sav"       // Autosave, resumed on startup
 
-    bool isLeftTeam;                // This player belongs to the left or to the right team
-    bool isPlayer;                  // If is a player or an AI
-    bool isAlive;
-} Player;
-
-typedef struct Building {
-    Rectangle rectangle;
-    Color color;
-} Building;
-
-typedef struct Explosion {
-    Vector2 position;
-    int radius;
-    bool active;
-} Explosion;
+#define PLAYER1COLOR CLITERAL(Color){163,105,35,255}
+#define PLAYER2COLOR CLITERAL(Color){249,191,48,255}
 
-typedef struct Ball {
-    Vector2 position;
-    Vector2 speed;
-    int radius;
-    bool active;
-} Ball;
+// Immutable copy of everything the render thread needs, published by the simulation after every tick
+typedef struct GameState {
+    unsigned int version;           // Changes whenever the scene has to be rendered again
+    unsigned int inputSequence;     // Last input applied by the simulation
+    unsigned int match;             // Changes on restart or load, the particles are cleared
+    bool gameOver;
+    bool pause;
+    bool animating;                 // Projectiles in flight
+    bool botThinking;               // A bot is choosing its shot, the frame has to be polled for it
+    bool cursorBlinking;
+    int mouseCursor;
+    int playerTurn;
+    int worldWidth;
+    Player player[MAX_PLAYERS];
+    Explosion explosion[MAX_EXPLOSIONS];
+    Vector2 projectile[MAX_PROJECTILES];
+    int projectileCount;
+    AimInput aim;
+    bool mouseOnText1;
+    bool mouseOnText2;
+    int framesCounter1;
+    int framesCounter2;
+    unsigned int explosionCount;    // Explosions since startup, the last MAX_EXPLOSION_EVENTS are kept
+    Vector2 explosionEvent[MAX_EXPLOSION_EVENTS];
+    unsigned int shotCount;         // Shots fired since startup
+    double shotKeyTime;             // Last shot: fire key sampled
+    double shotFireTime;            // Last shot: projectile spawned by the simulation
+    int buildingCount;
+    Building building[MAX_WORLD_BUILDINGS];     // Last, only the buildings of the match are copied
+} GameState;
 
 static const int screenWidth = 800;
 static const int screenHeight = 450;
 
+// NOTE: Gameplay always runs in screenWidth x screenHeight coordinates,
+// the frame is rendered into an internal target and upscaled (letterboxed) to the window
+static float renderScale = 1.0f;
+static RenderTexture2D target = { 0 };
+static Camera2D uiCamera = { 0 };
+static Rectangle renderArea = { 0 };
+
+// NOTE: The world may be many screens wide, the world camera scrolls along it following the shot (or the player aiming).
+// The text boxes and messages stay in screen coordinates, drawn with the UI camera
+static int worldWidth = screenWidth;
+static Camera2D worldCamera = { 0 };
+static float viewX = 0.0f;              // Render thread: left side of the view, in world coordinates
+static unsigned int viewMatch = 0;
+
+// NOTE: The scene is only rendered again when something changed, otherwise the last frame is reused.
+// With idle mode, frames without animations wait for the next input event instead of polling at 60 FPS
+static bool idleMode = true;
+static bool sceneDirty = true;         // Simulation: the next published state has to be rendered again
+static bool wasAnimating = false;       // Render thread: particles were moving on the last frame
+
+// NOTE: The simulation runs at a fixed tick on its own thread, a render or vsync stall does not delay it.
+// Input events go to the simulation through pendingInput, the state comes back through a lock-free triple buffer
+// While nothing can change without input, the simulation thread sleeps until the render thread samples some
+static bool threaded = true;
+static InputQueue pendingInput = { 0 };
+static GameState gameState[3] = { 0 };
+static TripleBuffer stateBuffer = { 0 };
+static unsigned int stateVersion = 0;
+static unsigned int matchNumber = 0;
+static unsigned int explosionCount = 0;
+static Vector2 explosionEvent[MAX_EXPLOSION_EVENTS] = { 0 };
+static int mouseCursor = MOUSE_CURSOR_DEFAULT;
+
+#if defined(SIMULATION_THREADED)
+static pthread_t simulation;
+static pthread_mutex_t inputMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t inputSampled = PTHREAD_COND_INITIALIZER;    // An idle simulation waits on it, with inputMutex
+static bool simulationRunning = false;
+static bool simulationWake = false;     // Something to do since the last TakeInput(), guarded by inputMutex
+#endif
+
+// Render thread state
+static const GameState *state = NULL;
+static bool targetDirty = true;
+static unsigned int drawnVersion = 0;
+static unsigned int sampledSequence = 0;
+static unsigned int particleMatch = 0;
+static unsigned int emittedExplosions = 0;
+static int appliedCursor = MOUSE_CURSOR_DEFAULT;
+static unsigned int drawnFrames = 0;    // The first frame may allocate, the next ones are checked with ALLOC_CHECK
+
+// Predicted path of the aim being typed, traced again only when the aim, the turn or the craters changed
+static Vector2 previewPoint[PREVIEW_MAX_POINTS] = { 0 };
+static int previewCount = 0;
+static int previewAngle = -1;
+static int previewPower = -1;
+static int previewTurn = -1;
+static unsigned int previewMatch = 0;
+static unsigned int previewExplosions = 0;
+
+// NOTE: Latency mode measures the fire key to the first presented frame showing the bomb, once EndDrawing() returned.
+// It includes the swap and its vsync wait, the display scanout and the time before the key was polled are not included
+static bool latencyMode = false;
+static FILE *latencyLog = NULL;
+static LatencyHistogram photonLatency = { 0 };
+static unsigned int measuredShots = 0;
+
 static bool gameOver = false;
 static bool pause = false;
-char power[MAX_INPUT_CHARS + 1] = "\0";
-char angle[MAX_INPUT_CHARS + 1] = "\0";
+static bool fixedPointMode = false;     // Bit-exact projectile integration for lockstep and replays, from the next match
+static bool botThinking = false;        // The bot of the current player has its request, waiting for the shot
+static AimInput aim = { 0 };        // Power (first text box) and angle (second one)
+
+// Key to fire latency: from the fire key being sampled to the projectile being spawned
+static LatencyHistogram fireLatency = { 0 };
+static unsigned int shotCount = 0;
+static double shotKeyTime = 0.0;
+static double shotFireTime = 0.0;
+
+// Shot in flight, logged with --telemetry once it landed
+static TelemetryShot flyingShot = { 0 };
+static bool trackingShot = false;       // The shot was fired by this run, not resumed in flight
+static int matchTurn = 0;
+static float frameTime = 0.0f;          // Last render frame time the simulation was told about
 
 static Player player[MAX_PLAYERS] = { 0 };
-static Building building[MAX_BUILDINGS] = { 0 };
+static Building building[MAX_WORLD_BUILDINGS] = { 0 };     // Sorted by x, as generated
+static int buildingCount = 0;
 static Explosion explosion[MAX_EXPLOSIONS] = { 0 };
-static Ball ball = { 0 };
+// NOTE: Per-match buffers live in the match arena, steady state play never touches the heap
+static Arena matchArena = { 0 };
+static ProjectilePool *projectiles = NULL;
+static TerrainField *terrain = NULL;
+static ParticlePool debris = { 0 };
+static ParticlePool smoke = { 0 };
 
 static int playerTurn = 0;
-static bool ballOnAir = false;
+static int explosionNumber = 0;
+static unsigned int levelSeed = 0;
 
 Image player1Image;
 Image player2Image;
@@ -92,54 +200,196 @@ Texture2D player1Texture;
 Texture2D player2Texture;
 Texture2D bombTexture;
 
-int letterCount1 = 0;
 Rectangle textBox1 = { screenWidth/2.0f - 100, 300, 225, 50 };
 bool mouseOnText1 = false;
 int framesCounter1 = 0;
 
-int letterCount2 = 0;
 Rectangle textBox2 = { screenWidth/2.0f - 100, 350, 225, 50 };
 bool mouseOnText2 = false;
 int framesCounter2 = 0;
 
 static void InitGame(void);         // Initialize game
-static void UpdateGame(void);       // Update game (one frame)
+static void UpdateGame(const InputQueue *input);    // Update game (one tick)
 static void DrawGame(void);         // Draw game (one frame)
+static void DrawScene(void);        // Draw game scene into the render target
 static void UnloadGame(void);       // Unload game
-static void UpdateDrawFrame(void);  // Update and Draw (one frame)
+static void UpdateDrawFrame(void);  // Sample input and Draw (one frame), and Update when single threaded
+static void UpdateRenderTarget(void);   // Fit the game to the window and resize the internal target
+static bool UpdateView(void);           // Render thread: scroll the world camera, returns true while it moves
+static bool IsInView(float left, float right);  // Render thread: x range overlaps the view
+static bool UpdateShotPreview(void);    // Render thread: path of the aim being typed, false if there is none
+static bool IsAnimating(void);          // Something moves without any input
+static bool IsCursorVisible(int framesCounter);
+
+// Simulation and render threads
+static void StartSimulation(void);  // Run the simulation on its own thread, if threads are available
+static void StopSimulation(void);
+static void SimulateTick(void);     // Apply the pending input, update and publish the state
+#if defined(SIMULATION_THREADED)
+static bool IsSimulationIdle(void); // Nothing changes until the next input
+#endif
+static void WakeSimulation(void);   // The next tick of an idle simulation has to run
+static void SampleInput(void);      // Render thread: queue this frame input for the simulation
+static void TakeInput(InputQueue *input);
+static void PublishGameState(unsigned int inputSequence);
+static void UpdateParticleEffects(void);    // Render thread: particles follow the published explosions
+static void MeasurePhotonLatency(void);     // Render thread: first frame presented with a new shot
 
 // Additional module functions
-static void InitBuildings(void);
-static void InitPlayers(void);
-static bool UpdatePlayer(int playerTurn);
-static bool UpdateBall(int playerTurn);
-
-int main(void)
+static void LoadGame(void);         // Load game resources, once
+static void InitBuildings(const Level *level);
+static void InitPlayers(const Level *level);
+static void UpdateAimField(const InputEvent *event);
+static bool UpdatePlayer(int playerTurn, const InputEvent *fire);
+static bool UpdateBot(int playerTurn);
+static void GetGameView(int playerTurn, GameView *view);
+static void FireProjectile(int playerTurn);
+static void TrackShot(int playerTurn);     // Start the telemetry record of a shot
+static void LogLandedShot(void);
+static bool UpdateProjectiles(void);
+static bool UpdateProjectile(int index);
+static void QueueExplosionEffect(Vector2 position);    // Simulation side of SpawnExplosionParticles()
+static void SpawnExplosionParticles(Vector2 position);
+static void SaveGame(void);         // Save the game state snapshot
+static bool LoadSavedGame(void);    // Resume from the game state snapshot, if any
+static CollisionWorld GetCollisionWorld(void);
+
+int main(int argc, char *argv[])
 {
+    bool fullscreen = false;
+    bool resume = true;
+    int workers = -1;
+    bool pinWorkers = false;
+    bool vsync = false;
+    int targetFPS = 60;
+    float fairThreshold = FAIRNESS_DEFAULT_THRESHOLD;
+    float fairBudget = FAIRNESS_DEFAULT_BUDGET;
+
+    // Command line: [--render-scale <scale>] [--fullscreen] [--no-idle] [--no-resume] [--single-thread] [--workers <count>] [--pin-workers]
+    //               [--vsync] [--fps <target, 0 for unlimited>] [--latency] [--latency-log <file.csv>] [--fixed-point]
+    //               [--bot <player> <library.so>] [--bot-process <player> <command>] [--bot-budget <milliseconds>]
+    //               [--telemetry <file.shots>] [--fair-levels <balance, 0..1>] [--fair-budget <milliseconds>] [--world-screens <count>]
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--render-scale") == 0) && (i + 1 < argc)) renderScale = (float)atof(argv[++i]);
+        else if (strcmp(argv[i], "--fullscreen") == 0) fullscreen = true;
+        else if (strcmp(argv[i], "--no-idle") == 0) idleMode = false;
+        else if (strcmp(argv[i], "--no-resume") == 0) resume = false;
+        else if (strcmp(argv[i], "--single-thread") == 0) threaded = false;
+        else if ((strcmp(argv[i], "--workers") == 0) && (i + 1 < argc)) workers = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--pin-workers") == 0) pinWorkers = true;
+        else if (strcmp(argv[i], "--vsync") == 0) vsync = true;
+        else if ((strcmp(argv[i], "--fps") == 0) && (i + 1 < argc)) targetFPS = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--latency") == 0) latencyMode = true;
+        else if (strcmp(argv[i], "--fixed-point") == 0) fixedPointMode = true;
+        else if ((strcmp(argv[i], "--bot") == 0) && (i + 2 < argc))
+        {
+            LoadBot(atoi(argv[i + 1]) - 1, argv[i + 2]);
+            i += 2;
+        }
+        else if ((strcmp(argv[i], "--bot-process") == 0) && (i + 2 < argc))
+        {
+            LoadBotProcess(atoi(argv[i + 1]) - 1, argv[i + 2]);
+            i += 2;
+        }
+        else if ((strcmp(argv[i], "--fair-levels") == 0) && (i + 1 < argc))
+        {
+            fairThreshold = (float)atof(argv[++i]);
+            SetLevelGenerator(GenerateFairLevel);
+        }
+        else if ((strcmp(argv[i], "--fair-budget") == 0) && (i + 1 < argc)) fairBudget = (float)atof(argv[++i])/1000.0f;
+        else if ((strcmp(argv[i], "--world-screens") == 0) && (i + 1 < argc)) worldWidth = atoi(argv[++i])*screenWidth;
+        else if ((strcmp(argv[i], "--telemetry") == 0) && (i + 1 < argc)) OpenTelemetry(argv[++i]);
+        else if ((strcmp(argv[i], "--bot-budget") == 0) && (i + 1 < argc)) SetBotBudget((float)atof(argv[++i])/1000.0f);
+        else if ((strcmp(argv[i], "--latency-log") == 0) && (i + 1 < argc))
+        {
+            latencyMode = true;
+            latencyLog = fopen(argv[++i], "w");
+            if (latencyLog != NULL) fprintf(latencyLog, "shot,key_to_fire_ms,fire_to_photon_ms,key_to_photon_ms,frame_ms\n");
+        }
+    }
+
+    if (renderScale < MIN_RENDER_SCALE) renderScale = MIN_RENDER_SCALE;
+    if (renderScale > MAX_RENDER_SCALE) renderScale = MAX_RENDER_SCALE;
+    if (worldWidth < screenWidth) worldWidth = screenWidth;
+    if (worldWidth > MAX_WORLD_SCREENS*screenWidth) worldWidth = MAX_WORLD_SCREENS*screenWidth;
+
+    SetConfigFlags(FLAG_WINDOW_RESIZABLE | (vsync? FLAG_VSYNC_HINT : 0));
     InitWindow(screenWidth, screenHeight, "Gorilla");
+    SetWindowMinSize(screenWidth/4, screenHeight/4);
+
+    if (fullscreen) ToggleBorderlessWindowed();
+
+    // Shared by every parallel workload, starting with the level generation
+    InitJobSystem(workers, pinWorkers);
+    SetLevelFairness(fairThreshold, fairBudget);
+    InitLevelQueue((unsigned int)time(NULL), worldWidth, screenHeight);
+
+    LoadGame();
+
+    // The terrain samples grow with the world width
+    if (!InitArena(&matchArena, MATCH_ARENA_SIZE + GetTerrainSampleCount(worldWidth, screenHeight)*sizeof(float))) return EXIT_FAILURE;
 
     InitGame();
 
-    SetTargetFPS(60);
+    if (resume) LoadSavedGame();
+
+    // The render thread needs a state before the first tick
+    InitTripleBuffer(&stateBuffer);
+    PublishGameState(0);
+    StartSimulation();
+
+#if defined(PLATFORM_WEB)
+    // NOTE: The browser owns the main loop, a blocking loop would freeze the page, frames follow requestAnimationFrame()
+    (void)targetFPS;
+    emscripten_set_main_loop(UpdateDrawFrame, 0, 1);
+#else
+    SetTargetFPS(targetFPS);
 
     while (!WindowShouldClose())
     {
         UpdateDrawFrame();
     }
+#endif
+
+    StopSimulation();
+    SaveGame();
+    CloseSnapshotWriter();
+    CloseTelemetry();
+
+    if (fireLatency.count > 0) LogLatencyHistogram(&fireLatency, "Key to fire");
+
+    if (latencyMode)
+    {
+        LogLatencyHistogram(&photonLatency, "Key to photon");
+        if (latencyLog != NULL) fclose(latencyLog);
+    }
 
     UnloadGame();
+    UnloadRenderTexture(target);
+    CloseLevelQueue();
+    CloseJobSystem();
+    CloseArena(&matchArena);
+    UnloadBots();
 
     CloseWindow();
 
+    // The allocation check build fails when steady state frames or ticks touched the heap
+    if (IsAllocationCheckEnabled())
+    {
+        unsigned int violations = GetAllocationViolations();
+
+        TraceLog((violations > 0)? LOG_ERROR : LOG_INFO, "ALLOC: %u heap allocations in total, %u in steady state frames and ticks", GetAllocationCount(), violations);
+
+        if (violations > 0) return EXIT_FAILURE;
+    }
+
     return 0;
 }
 
-void InitGame(void)
+// Load game resources, they are kept across restarts
+static void LoadGame(void)
 {
-    ball.radius = 10;
-    ballOnAir = false;
-    ball.active = false;
-
     player1Image = LoadImage("res/player1Image.png");
     player2Image = LoadImage("res/player2Image.png");
     bombImage = LoadImage("res/bombImage.png");
@@ -148,8 +398,41 @@ void InitGame(void)
     player2Texture = LoadTextureFromImage(player2Image);
     bombTexture = LoadTextureFromImage(bombImage);
 
-    InitBuildings();
-    InitPlayers();
+    // NOTE: Particles are cosmetic, they live on the render thread and are not part of the game state
+    InitParticlePool(&debris, 1.5f, GRAVITY*DELTA_FPS, 0.5f, 3, DARKGRAY);
+    InitParticlePool(&smoke, 2.5f, -GRAVITY*DELTA_FPS*0.05f, 2.0f, 6, Fade(LIGHTGRAY, 0.6f));
+    LoadParticleMesh();
+}
+
+void InitGame(void)
+{
+    // Everything from the previous match is released at once
+    ResetArena(&matchArena);
+    projectiles = (ProjectilePool *)ArenaAlloc(&matchArena, sizeof(ProjectilePool));
+    terrain = (TerrainField *)ArenaAlloc(&matchArena, sizeof(TerrainField));
+    terrain->distance = (float *)ArenaAlloc(&matchArena, GetTerrainSampleCount(worldWidth, screenHeight)*sizeof(float));
+
+    InitProjectilePool(projectiles);
+    projectiles->fixedPoint = fixedPointMode;
+    explosionNumber = 0;
+    matchNumber++;
+    matchTurn = 0;
+    trackingShot = false;
+
+    // Bots rebuilt since the last match play this one
+    CancelBotShots();
+    ReloadChangedBots();
+    botThinking = false;
+
+    // NOTE: Levels are generated in the background, a restart only copies the next one
+    Level level = { 0 };
+    GetNextLevel(&level);
+    levelSeed = level.seed;
+
+    InitBuildings(&level);
+    InitPlayers(&level);
+
+    sceneDirty = true;
 
     // Init explosions
     for (int i = 0; i < MAX_EXPLOSIONS; i++)
@@ -158,156 +441,133 @@ void InitGame(void)
         explosion[i].radius = 30;
         explosion[i].active = false;
     }
+
+    CollisionWorld world = GetCollisionWorld();
+    BuildTerrainField(terrain, &world);
 }
 
-// Update game (one frame)
-void UpdateGame(void)
+// Update game (one tick)
+void UpdateGame(const InputQueue *input)
 {
+    // NOTE: Events are applied in the order they were sampled, a fire waits for the aiming step
+    const InputEvent *fire = NULL;
+
     if (!gameOver)
     {
-        if (IsKeyPressed('P')) pause = !pause;
-
         if (!pause)
         {
-            if (CheckCollisionPointRec(GetMousePosition(), textBox1)) mouseOnText1 = true;
+            bool wasOnText1 = mouseOnText1;
+            bool wasOnText2 = mouseOnText2;
+
+            if (CheckCollisionPointRec(input->mousePosition, textBox1)) mouseOnText1 = true;
             else mouseOnText1 = false;
 
-            if (CheckCollisionPointRec(GetMousePosition(), textBox2)) mouseOnText2 = true;
+            if (CheckCollisionPointRec(input->mousePosition, textBox2)) mouseOnText2 = true;
             else mouseOnText2 = false;
-            
 
-        if (mouseOnText1)
-        {
-            // Set the window's cursor to the I-Beam
-            SetMouseCursor(MOUSE_CURSOR_IBEAM);
+            if ((mouseOnText1 != wasOnText1) || (mouseOnText2 != wasOnText2)) sceneDirty = true;
+        }
 
-            // Get char pressed (unicode character) on the queue
-            int key1 = GetCharPressed();
+        for (int i = 0; i < input->eventCount; i++)
+        {
+            const InputEvent *event = &input->event[i];
 
-            // Check if more characters have been pressed on the same frame
-            while (key1 > 0)
+            if (event->type == INPUT_PAUSE)
             {
-                // NOTE: Only allow keys in range [48..57]
-                if ((key1 >= 48) && (key1 <= 57) && (letterCount1 < MAX_INPUT_CHARS))
-                {
-                    power[letterCount1] = (char)key1;
-                    power[letterCount1 + 1] = '\0'; // Add null terminator at the end of the string.
-                    letterCount1++;
-                }
-
-                key1 = GetCharPressed(); // Check next character in the queue
+                pause = !pause;
+                sceneDirty = true;
             }
-
-            if (IsKeyPressed(KEY_BACKSPACE))
+            else if (!pause)
             {
-                letterCount1--;
-                if (letterCount1 < 0)
-                    letterCount1 = 0;
-                power[letterCount1] = '\0';
+                if (event->type == INPUT_FIRE) fire = event;
+                else if ((event->type == INPUT_DIGIT) || (event->type == INPUT_BACKSPACE)) UpdateAimField(event);
             }
         }
-        else
-            SetMouseCursor(MOUSE_CURSOR_DEFAULT);
 
-        if (mouseOnText1)
-            framesCounter1++;
-        else
-            framesCounter1 = 0;
-
-        if (mouseOnText2)
+        if (!pause)
         {
-            // Set the window's cursor to the I-Beam
-            SetMouseCursor(MOUSE_CURSOR_IBEAM);
+            // Set the window's cursor to the I-Beam over the text boxes
+            if (mouseOnText1 || mouseOnText2) mouseCursor = MOUSE_CURSOR_IBEAM;
+            else mouseCursor = MOUSE_CURSOR_DEFAULT;
 
-            // Get char pressed (unicode character) on the queue
-            int key2 = GetCharPressed();
+            if (mouseOnText1)
+                framesCounter1++;
+            else
+                framesCounter1 = 0;
 
-            // Check if more characters have been pressed on the same frame
-            while (key2 > 0)
-            {
-                // NOTE: Only allow keys in range [48..57]
-                if ((key2 >= 48) && (key2 <= 57) && (letterCount2 < MAX_INPUT_CHARS))
-                {
-                    angle[letterCount2] = (char)key2;
-                    angle[letterCount2 + 1] = '\0'; // Add null terminator at the end of the string.
-                    letterCount2++;
-                }
+            // Cursor blink phase changed
+            if (mouseOnText1 && (framesCounter1 <= CURSOR_IDLE_FRAMES) && ((framesCounter1%CURSOR_BLINK_FRAMES) == 0)) sceneDirty = true;
 
-                key2 = GetCharPressed(); // Check next character in the queue
-            }
+            if (mouseOnText2)
+                framesCounter2++;
+            else
+                framesCounter2 = 0;
+
+            // Cursor blink phase changed
+            if (mouseOnText2 && (framesCounter2 <= CURSOR_IDLE_FRAMES) && ((framesCounter2%CURSOR_BLINK_FRAMES) == 0)) sceneDirty = true;
 
-            if (IsKeyPressed(KEY_BACKSPACE))
+            if (projectiles->count == 0) // If we are aiming
             {
-                letterCount2--;
-                if (letterCount2 < 0)
-                    letterCount2 = 0;
-                angle[letterCount2] = '\0';
+                if (player[playerTurn].isPlayer) UpdatePlayer(playerTurn, fire);
+                else UpdateBot(playerTurn);
             }
-        }
-        else
-            SetMouseCursor(MOUSE_CURSOR_DEFAULT);
-
-        if (mouseOnText2)
-            framesCounter2++;
-        else
-            framesCounter2 = 0;
-
-        if (!ballOnAir)
-            ballOnAir = UpdatePlayer(playerTurn); // If we are aiming
-        else
-        {int letterCount1 = 0;
-            Rectangle textBox1 = {screenWidth / 2.0f - 100, 300, 225, 50};
-            bool mouseOnText1 = false;
-            int framesCounter1 = 0;
-
-            int letterCount2 = 0;
-            Rectangle textBox2 = {screenWidth / 2.0f - 100, 350, 225, 50};
-            bool mouseOnText2 = false;
-            int framesCounter2 = 0;
-            if (UpdateBall(playerTurn)) // If collision
+            else
             {
-                // Game over logic
-                bool leftTeamAlive = false;
-                bool rightTeamAlive = false;
-
-                for (int i = 0; i < MAX_PLAYERS; i++)
+                if (UpdateProjectiles()) // If every projectile of the volley collided
                 {
-                    if (player[i].isAlive)
+                    LogLandedShot();
+
+                    // Game over logic
+                    bool leftTeamAlive = false;
+                    bool rightTeamAlive = false;
+
+                    for (int i = 0; i < MAX_PLAYERS; i++)
                     {
-                        if (player[i].isLeftTeam)
-                            leftTeamAlive = true;
-                        if (!player[i].isLeftTeam)
-                            rightTeamAlive = true;
+                        if (player[i].isAlive)
+                        {
+                            if (player[i].isLeftTeam)
+                                leftTeamAlive = true;
+                            if (!player[i].isLeftTeam)
+                                rightTeamAlive = true;
+                        }
                     }
-                }
 
-                if (leftTeamAlive && rightTeamAlive)
-                {
-                    ballOnAir = false;
-                    ball.active = false;
+                    sceneDirty = true;
+
+                    if (leftTeamAlive && rightTeamAlive)
+                    {
+                        playerTurn++;
 
-                    playerTurn++;
+                        if (playerTurn == MAX_PLAYERS)
+                            playerTurn = 0;
 
-                    if (playerTurn == MAX_PLAYERS)
-                        playerTurn = 0;
-                }
-                else
-                {
-                    gameOver = true;
+                        SaveGame();
+                    }
+                    else
+                    {
+                        gameOver = true;
 
-                    // if (leftTeamAlive) left team wins
-                    // if (rightTeamAlive) right team wins
+                        // if (leftTeamAlive) left team wins
+                        // if (rightTeamAlive) right team wins
+
+                        SaveGame();
+                    }
                 }
             }
         }
-        }
     }
     else
     {
-        if (IsKeyPressed(KEY_SPACE))
+        for (int i = 0; i < input->eventCount; i++)
+        {
+            if (input->event[i].type == INPUT_FIRE) fire = &input->event[i];
+        }
+
+        if (fire != NULL)
         {
             InitGame();
             gameOver = false;
+            SaveGame();
         }
     }
 }
@@ -315,130 +575,176 @@ void UpdateGame(void)
 // Draw game (one frame)
 void DrawGame(void)
 {
+    // Nothing changed since the last frame: only present the previous one again
+    if (targetDirty || (state->version != drawnVersion))
+    {
+        DrawScene();
+        drawnVersion = state->version;
+        targetDirty = false;
+    }
+
     BeginDrawing();
 
+        ClearBackground(BLACK);
+
+        // Upscale the internal target to the window (render textures are flipped vertically)
+        DrawTexturePro(target.texture, (Rectangle){ 0, 0, (float)target.texture.width, -(float)target.texture.height }, renderArea, (Vector2){ 0, 0 }, 0.0f, WHITE);
+
+    EndDrawing();
+
+    if (latencyMode) MeasurePhotonLatency();
+}
+
+// Draw the game scene into the internal render target
+static void DrawScene(void)
+{
+    BeginTextureMode(target);
+    BeginMode2D(worldCamera);
+
         ClearBackground(SKYBLUE);
 
-        if (!gameOver)
+        if (!state->gameOver)
         {
-            // Draw buildings
-            for (int i = 0; i < MAX_BUILDINGS; i++) DrawRectangleRec(building[i].rectangle, building[i].color);
+            // Draw buildings, only the ones in view: they are sorted by x
+            for (int i = FindFirstBuilding(state->building, state->buildingCount, viewX); i < state->buildingCount; i++)
+            {
+                if (state->building[i].rectangle.x >= viewX + screenWidth) break;
+                DrawRectangleRec(state->building[i].rectangle, state->building[i].color);
+            }
 
             // Draw explosions
             for (int i = 0; i < MAX_EXPLOSIONS; i++)
             {
-                if (explosion[i].active) DrawCircle(explosion[i].position.x, explosion[i].position.y, explosion[i].radius, SKYBLUE);
+                if (state->explosion[i].active && IsInView(state->explosion[i].position.x - state->explosion[i].radius, state->explosion[i].position.x + state->explosion[i].radius))
+                    DrawCircle(state->explosion[i].position.x, state->explosion[i].position.y, state->explosion[i].radius, SKYBLUE);
             }
 
             // Draw players
             for (int i = 0; i < MAX_PLAYERS; i++)
             {
-                if (player[i].isAlive)
+                float spriteX = state->player[i].position.x - state->player[i].size.x/2 - 5;
+
+                if (state->player[i].isAlive)
                 {
-                    if (player[i].isLeftTeam)
+                    if (state->player[i].isLeftTeam)
                     {
-                        DrawTexture(player1Texture, player[i].position.x - player[i].size.x/2 - 5, player[i].position.y - player[i].size.y/2 - 7, WHITE);
+                        if (IsInView(spriteX, spriteX + player1Texture.width)) DrawTexture(player1Texture, spriteX, state->player[i].position.y - state->player[i].size.y/2 - 7, WHITE);
                     }
                     else
                     {
-                        DrawTexture(player2Texture, player[i].position.x - player[i].size.x/2 - 5, player[i].position.y - player[i].size.y/2 - 7, WHITE);
+                        if (IsInView(spriteX, spriteX + player2Texture.width)) DrawTexture(player2Texture, spriteX, state->player[i].position.y - state->player[i].size.y/2 - 7, WHITE);
                     }
                 }
             }
 
-            // Draw ball
-            if (ball.active)
+            // Draw explosion particles, smoke over debris
+            DrawParticles((const ParticlePool *[]){ &debris, &smoke }, 2);
+
+            // Draw projectiles
+            for (int i = 0; i < state->projectileCount; i++)
             {
-                DrawTexture(bombTexture, ball.position.x - 18, ball.position.y - 30, WHITE);
+                if (IsInView(state->projectile[i].x - 18, state->projectile[i].x - 18 + bombTexture.width)) DrawTexture(bombTexture, state->projectile[i].x - 18, state->projectile[i].y - 30, WHITE);
             }
 
+            // Draw the predicted path of the aim, one line strip
+            if (UpdateShotPreview()) DrawLineStrip(previewPoint, previewCount, Fade(state->player[state->playerTurn].isLeftTeam? PLAYER1COLOR : PLAYER2COLOR, 0.8f));
+        }
+
+    EndMode2D();
+
+    // Text boxes and messages do not scroll with the world
+    BeginMode2D(uiCamera);
+
+        if (!state->gameOver)
+        {
             // Draw the angle and the power of the aim, and the previous ones
-            if (!ballOnAir)
+            if (state->projectileCount == 0)
             {
                 // Draw textboxes
-                if (player[playerTurn].isLeftTeam) //first player
+                if (state->player[state->playerTurn].isLeftTeam) //first player
                 {
                     DrawRectangleRec(textBox1, (Color){ 0, 0, 0, 100 });
-                    if (mouseOnText1)
+                    if (state->mouseOnText1)
                         DrawRectangleLines((int)textBox1.x, (int)textBox1.y, (int)textBox1.width, (int)textBox1.height, PLAYER1COLOR);
                     else
                         DrawRectangleLines((int)textBox1.x, (int)textBox1.y, (int)textBox1.width, (int)textBox1.height, BLACK);
 
-                    DrawText(power, (int)textBox1.x + 5, (int)textBox1.y + 8, 40, PLAYER1COLOR);
+                    DrawTextCached(state->aim.power.text, (int)textBox1.x + 5, (int)textBox1.y + 8, 40, PLAYER1COLOR);
 
-                    if (mouseOnText1)
+                    if (state->mouseOnText1)
                     {
-                        if (letterCount1 < MAX_INPUT_CHARS)
+                        if (state->aim.power.length < MAX_INPUT_CHARS)
                         {
                             // Draw blinking underscore char
-                            if (((framesCounter1 / 20) % 2) == 0)
-                                DrawText("_", (int)textBox1.x + 8 + MeasureText(power, 40), (int)textBox1.y + 12, 40, PLAYER1COLOR);
+                            if (IsCursorVisible(state->framesCounter1))
+                                DrawTextCached("_", (int)textBox1.x + 8 + MeasureTextCached(state->aim.power.text, 40), (int)textBox1.y + 12, 40, PLAYER1COLOR);
                         }
                     }
 
                     DrawRectangleRec(textBox2, (Color){ 0, 0, 0, 100 });
-                    if (mouseOnText2)
+                    if (state->mouseOnText2)
                         DrawRectangleLines((int)textBox2.x, (int)textBox2.y, (int)textBox2.width, (int)textBox2.height, PLAYER1COLOR);
                     else
                         DrawRectangleLines((int)textBox2.x, (int)textBox2.y, (int)textBox2.width, (int)textBox2.height, BLACK);
 
-                    DrawText(angle, (int)textBox2.x + 5, (int)textBox2.y + 8, 40, PLAYER1COLOR);
+                    DrawTextCached(state->aim.angle.text, (int)textBox2.x + 5, (int)textBox2.y + 8, 40, PLAYER1COLOR);
 
-                    if (mouseOnText2)
+                    if (state->mouseOnText2)
                     {
-                        if (letterCount2 < MAX_INPUT_CHARS)
+                        if (state->aim.angle.length < MAX_INPUT_CHARS)
                         {
                             // Draw blinking underscore char
-                            if (((framesCounter2 / 20) % 2) == 0)
-                                DrawText("_", (int)textBox2.x + 8 + MeasureText(angle, 40), (int)textBox2.y + 12, 40, PLAYER1COLOR);
+                            if (IsCursorVisible(state->framesCounter2))
+                                DrawTextCached("_", (int)textBox2.x + 8 + MeasureTextCached(state->aim.angle.text, 40), (int)textBox2.y + 12, 40, PLAYER1COLOR);
                         }
                     }
                 }
                 else //second player
                 {
                     DrawRectangleRec(textBox1, (Color){ 0, 0, 0, 100 });
-                    if (mouseOnText1)
+                    if (state->mouseOnText1)
                         DrawRectangleLines((int)textBox1.x, (int)textBox1.y, (int)textBox1.width, (int)textBox1.height, PLAYER2COLOR);
                     else
                         DrawRectangleLines((int)textBox1.x, (int)textBox1.y, (int)textBox1.width, (int)textBox1.height, BLACK);
 
-                    DrawText(power, (int)textBox1.x + 5, (int)textBox1.y + 8, 40, PLAYER2COLOR);
+                    DrawTextCached(state->aim.power.text, (int)textBox1.x + 5, (int)textBox1.y + 8, 40, PLAYER2COLOR);
 
-                    if (mouseOnText1)
+                    if (state->mouseOnText1)
                     {
-                        if (letterCount1 < MAX_INPUT_CHARS)
+                        if (state->aim.power.length < MAX_INPUT_CHARS)
                         {
                             // Draw blinking underscore char
-                            if (((framesCounter1 / 20) % 2) == 0)
-                                DrawText("_", (int)textBox1.x + 8 + MeasureText(power, 40), (int)textBox1.y + 12, 40, PLAYER2COLOR);
+                            if (IsCursorVisible(state->framesCounter1))
+                                DrawTextCached("_", (int)textBox1.x + 8 + MeasureTextCached(state->aim.power.text, 40), (int)textBox1.y + 12, 40, PLAYER2COLOR);
                         }
                     }
 
                     DrawRectangleRec(textBox2, (Color){ 0, 0, 0, 100 });
-                    if (mouseOnText2)
+                    if (state->mouseOnText2)
                         DrawRectangleLines((int)textBox2.x, (int)textBox2.y, (int)textBox2.width, (int)textBox2.height, PLAYER2COLOR);
                     else
                         DrawRectangleLines((int)textBox2.x, (int)textBox2.y, (int)textBox2.width, (int)textBox2.height, BLACK);
 
-                    DrawText(angle, (int)textBox2.x + 5, (int)textBox2.y + 8, 40, PLAYER2COLOR);
+                    DrawTextCached(state->aim.angle.text, (int)textBox2.x + 5, (int)textBox2.y + 8, 40, PLAYER2COLOR);
 
-                    if (mouseOnText2)
+                    if (state->mouseOnText2)
                     {
-                        if (letterCount2 < MAX_INPUT_CHARS)
+                        if (state->aim.angle.length < MAX_INPUT_CHARS)
                         {
                             // Draw blinking underscore char
-                            if (((framesCounter2 / 20) % 2) == 0)
-                                DrawText("_", (int)textBox2.x + 8 + MeasureText(angle, 40), (int)textBox2.y + 12, 40, PLAYER2COLOR);
+                            if (IsCursorVisible(state->framesCounter2))
+                                DrawTextCached("_", (int)textBox2.x + 8 + MeasureTextCached(state->aim.angle.text, 40), (int)textBox2.y + 12, 40, PLAYER2COLOR);
                         }
                     }
                 }
             }
 
-            if (pause) DrawText("GAME PAUSED", screenWidth/2 - MeasureText("GAME PAUSED", 40)/2, screenHeight/2 - 40, 40, BLACK);
+            if (state->pause) DrawTextCached("GAME PAUSED", screenWidth/2 - MeasureTextCached("GAME PAUSED", 40)/2, screenHeight/2 - 40, 40, BLACK);
         }
-        else DrawText("PRESS [SPACE] TO PLAY AGAIN", GetScreenWidth()/2 - MeasureText("PRESS [SPACE] TO PLAY AGAIN", 20)/2, GetScreenHeight()/2 - 50, 20, BLACK);
+        else DrawTextCached("PRESS [SPACE] TO PLAY AGAIN", screenWidth/2 - MeasureTextCached("PRESS [SPACE] TO PLAY AGAIN", 20)/2, screenHeight/2 - 50, 20, BLACK);
 
-    EndDrawing();
+    EndMode2D();
+    EndTextureMode();
 }
 
 // Unload game variables
@@ -450,48 +756,437 @@ void UnloadGame(void)
     UnloadTexture(player1Texture);
     UnloadTexture(player2Texture);
     UnloadTexture(bombTexture);
+    UnloadParticleMesh();
+    UnloadTextCache();
 }
 
-// Update and Draw (one frame)
+// Sample input and Draw (one frame), and Update when single threaded
 void UpdateDrawFrame(void)
 {
-    UpdateGame();
+    bool checkAllocations = (drawnFrames > 0);
+    if (checkAllocations) BeginAllocationCheck();
+
+    if (IsKeyPressed(KEY_F11)) ToggleBorderlessWindowed();
+
+    UpdateRenderTarget();
+    SampleInput();
+
+    if (!threaded) SimulateTick();
+
+    // Latest state published by the simulation, the previous one is kept if nothing new arrived
+    if (AcquireTripleBuffer(&stateBuffer)) state = &gameState[GetTripleBufferReadSlot(&stateBuffer)];
+
+    if (state->mouseCursor != appliedCursor)
+    {
+        SetMouseCursor(state->mouseCursor);
+        appliedCursor = state->mouseCursor;
+    }
+
+    UpdateParticleEffects();
+
+    // Animations need a new frame, and one more after they stop to clear their last state
+    bool animating = UpdateView() || IsAnimating();
+    if (animating || wasAnimating) targetDirty = true;
+    wasAnimating = animating;
+
+    // Nothing will change until the next input event, block in EndDrawing() until it arrives.
+    // Input the simulation has not applied yet will still change the state, keep polling until it is published
+    bool inputPending = (state->inputSequence != sampledSequence);
+
+    if (idleMode && !animating && !state->cursorBlinking && !inputPending && !state->botThinking) EnableEventWaiting();
+    else DisableEventWaiting();
+
     DrawGame();
+
+    if (checkAllocations) EndAllocationCheck();
+    drawnFrames++;
+}
+
+static void UpdateRenderTarget(void)
+{
+    // Biggest area with the game aspect ratio that fits the window
+    float scale = (float)GetScreenWidth()/screenWidth;
+    if ((float)GetScreenHeight()/screenHeight < scale) scale = (float)GetScreenHeight()/screenHeight;
+
+    renderArea.width = screenWidth*scale;
+    renderArea.height = screenHeight*scale;
+    renderArea.x = (GetScreenWidth() - renderArea.width)/2;
+    renderArea.y = (GetScreenHeight() - renderArea.height)/2;
+
+    // Mouse in gameplay coordinates
+    SetMouseOffset(-(int)renderArea.x, -(int)renderArea.y);
+    SetMouseScale(1.0f/scale, 1.0f/scale);
+
+    int width = (int)(renderArea.width*renderScale);
+    int height = (int)(renderArea.height*renderScale);
+
+    if (width < 1) width = 1;
+    if (height < 1) height = 1;
+
+    if ((target.texture.width != width) || (target.texture.height != height))
+    {
+        if (target.id != 0) UnloadRenderTexture(target);
+
+        target = LoadRenderTexture(width, height);
+        SetTextureFilter(target.texture, TEXTURE_FILTER_BILINEAR);
+        targetDirty = true;
+    }
+
+    uiCamera.zoom = (float)width/screenWidth;
+    worldCamera.zoom = uiCamera.zoom;
+}
+
+// Follow the shot in flight, or the player aiming, without going past the ends of the world
+static bool UpdateView(void)
+{
+    float previous = viewX;
+    float focus = (state->projectileCount > 0)? state->projectile[0].x : state->player[state->playerTurn].position.x;
+    float goal = focus - screenWidth/2.0f;
+
+    if (goal > state->worldWidth - screenWidth) goal = (float)(state->worldWidth - screenWidth);
+    if (goal < 0) goal = 0;
+
+    // A new match starts in place, otherwise the view eases toward its goal
+    if (state->match != viewMatch)
+    {
+        viewX = goal;
+        viewMatch = state->match;
+    }
+    else
+    {
+        float rate = CAMERA_FOLLOW_RATE*GetFrameTime();
+        if (rate > 1.0f) rate = 1.0f;
+
+        viewX += (goal - viewX)*rate;
+        if (fabsf(goal - viewX) < 0.5f) viewX = goal;
+    }
+
+    worldCamera.target.x = viewX;
+
+    return (viewX != previous);
+}
+
+static bool IsInView(float left, float right)
+{
+    return (right > viewX) && (left < viewX + screenWidth);
 }
 
-static void InitBuildings(void)
+// NOTE: Traced with the float integration, the path of a fixed-point match may differ by a fraction of a pixel
+static bool UpdateShotPreview(void)
 {
-    // Horizontal generation
-    int currentWidth = 0;
+    const Player *shooter = &state->player[state->playerTurn];
 
-    float relativeWidth = 100/(100 - BUILDING_RELATIVE_ERROR);
-    float buildingWidthMean = (screenWidth*relativeWidth/MAX_BUILDINGS) + 1;        // We add one to make sure we will cover the whole screen.
+    if ((state->projectileCount > 0) || !shooter->isPlayer || !IsAimValid(&state->aim)) return false;
 
-    // Vertical generation
-    int currentHeighth = 0;
-    int grayLevel;
+    // Same aim on the same world, the cached path is still right
+    if ((state->aim.angle.value == previewAngle) && (state->aim.power.value == previewPower) && (state->playerTurn == previewTurn) &&
+        (state->match == previewMatch) && (state->explosionCount == previewExplosions)) return true;
 
-    // Creation
-    for (int i = 0; i < MAX_BUILDINGS; i++)
+    CollisionWorld world = { state->building, state->buildingCount, state->explosion, MAX_EXPLOSIONS, state->player, MAX_PLAYERS, state->worldWidth, screenHeight };
+    Vector2 speed = GetShotSpeed(state->aim.angle.value, state->aim.power.value, shooter->isLeftTeam);
+
+    previewCount = TraceShot(&world, shooter->position, speed, PROJECTILE_RADIUS, state->playerTurn, previewPoint, PREVIEW_MAX_POINTS);
+
+    previewAngle = state->aim.angle.value;
+    previewPower = state->aim.power.value;
+    previewTurn = state->playerTurn;
+    previewMatch = state->match;
+    previewExplosions = state->explosionCount;
+
+    return true;
+}
+
+static bool IsAnimating(void)
+{
+    if (state->gameOver || state->pause) return false;
+
+    return state->animating || (debris.count > 0) || (smoke.count > 0);
+}
+
+// The cursor blinks for a while after the last input, then stays visible
+static bool IsCursorVisible(int framesCounter)
+{
+    return (framesCounter >= CURSOR_IDLE_FRAMES) || (((framesCounter/CURSOR_BLINK_FRAMES)%2) == 0);
+}
+
+#if defined(SIMULATION_THREADED)
+// Simulation thread: one tick every 1/DELTA_FPS seconds, on an absolute schedule so ticks do not drift
+static void *SimulationLoop(void *data)
+{
+    (void)data;
+
+    const long tickTime = 1000000000L/DELTA_FPS;
+    struct timespec next = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    bool checkAllocations = false;      // From the second tick, like the frames
+
+    while (__atomic_load_n(&simulationRunning, __ATOMIC_ACQUIRE))
     {
-        // Horizontal
-        building[i].rectangle.x = currentWidth;
-        building[i].rectangle.width = GetRandomValue(buildingWidthMean*(100 - BUILDING_RELATIVE_ERROR/2)/100 + 1, buildingWidthMean*(100 + BUILDING_RELATIVE_ERROR)/100);
+        if (checkAllocations) BeginAllocationCheck();
+        SimulateTick();
+        if (checkAllocations) EndAllocationCheck();
 
-        currentWidth += building[i].rectangle.width;
+        checkAllocations = true;
 
-        // Vertical
-        currentHeighth = GetRandomValue(BUILDING_MIN_RELATIVE_HEIGHT, BUILDING_MAX_RELATIVE_HEIGHT);
-        building[i].rectangle.y = screenHeight - (screenHeight*currentHeighth/100);
-        building[i].rectangle.height = screenHeight*currentHeighth/100 + 1;
+        // Nothing moves, no bot is thinking and the cursor does not blink: no tick until the render thread samples input
+        if (IsSimulationIdle())
+        {
+            pthread_mutex_lock(&inputMutex);
+            while (!simulationWake && __atomic_load_n(&simulationRunning, __ATOMIC_ACQUIRE)) pthread_cond_wait(&inputSampled, &inputMutex);
+            pthread_mutex_unlock(&inputMutex);
 
-        // Color
-        grayLevel = GetRandomValue(BUILDING_MIN_GRAYSCALE_COLOR, BUILDING_MAX_GRAYSCALE_COLOR);
-        building[i].color = (Color){ grayLevel, grayLevel, grayLevel, 255 };
+            // The schedule restarts from the input, there are no missed ticks to catch up
+            clock_gettime(CLOCK_MONOTONIC, &next);
+            continue;
+        }
+
+        next.tv_nsec += tickTime;
+        if (next.tv_nsec >= 1000000000L)
+        {
+            next.tv_sec++;
+            next.tv_nsec -= 1000000000L;
+        }
+
+        // A late tick runs right away to catch up, after a long stall (suspended process) the schedule restarts
+        struct timespec now = { 0 };
+        clock_gettime(CLOCK_MONOTONIC, &now);
+
+        long long late = (long long)(now.tv_sec - next.tv_sec)*1000000000LL + (now.tv_nsec - next.tv_nsec);
+        if (late > (long long)MAX_SIMULATION_LAG*tickTime) next = now;
+
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, NULL);
+    }
+
+    return NULL;
+}
+#endif
+
+static void StartSimulation(void)
+{
+#if defined(SIMULATION_THREADED)
+    if (!threaded) return;
+
+    simulationRunning = true;
+
+    // Without a thread the game still works, the simulation just ticks once per rendered frame
+    if (pthread_create(&simulation, NULL, SimulationLoop, NULL) != 0)
+    {
+        simulationRunning = false;
+        threaded = false;
     }
+#else
+    threaded = false;
+#endif
+}
+
+static void StopSimulation(void)
+{
+#if defined(SIMULATION_THREADED)
+    if (!simulationRunning) return;
+
+    __atomic_store_n(&simulationRunning, false, __ATOMIC_RELEASE);
+    WakeSimulation();
+    pthread_join(simulation, NULL);
+#endif
 }
 
-static void InitPlayers(void)
+static void SimulateTick(void)
+{
+    InputQueue input = { 0 };
+    TakeInput(&input);
+
+    for (int i = 0; i < input.eventCount; i++)
+    {
+        if (input.event[i].type == INPUT_SAVE) SaveGame();
+        else if (input.event[i].type == INPUT_LOAD) LoadSavedGame();
+    }
+
+    frameTime = input.frameTime;
+
+    UpdateGame(&input);
+    PublishGameState(input.sequence);
+}
+
+#if defined(SIMULATION_THREADED)
+static bool IsSimulationIdle(void)
+{
+    if (gameOver || pause) return true;
+
+    // A bot turn is polled every tick until the shot, a bot about to be asked is not idle either
+    bool cursorBlinking = (mouseOnText1 && (framesCounter1 < CURSOR_IDLE_FRAMES)) || (mouseOnText2 && (framesCounter2 < CURSOR_IDLE_FRAMES));
+
+    return (projectiles->count == 0) && player[playerTurn].isPlayer && !botThinking && !cursorBlinking;
+}
+#endif
+
+static void WakeSimulation(void)
+{
+#if defined(SIMULATION_THREADED)
+    pthread_mutex_lock(&inputMutex);
+    simulationWake = true;
+    pthread_cond_signal(&inputSampled);
+    pthread_mutex_unlock(&inputMutex);
+#endif
+}
+
+static void SampleInput(void)
+{
+#if defined(SIMULATION_THREADED)
+    pthread_mutex_lock(&inputMutex);
+#endif
+
+    // NOTE: raylib does not keep the time of each key press, events are stamped when the frame samples them
+    double time = GetTime();
+
+    Vector2 mousePosition = GetMousePosition();
+    bool sampled = (mousePosition.x != pendingInput.mousePosition.x) || (mousePosition.y != pendingInput.mousePosition.y);
+
+    pendingInput.mousePosition = mousePosition;
+    pendingInput.frameTime = GetFrameTime();
+
+    // Only digits reach the simulation, both text boxes are numeric
+    for (int key = GetCharPressed(); key > 0; key = GetCharPressed())
+    {
+        if ((key >= '0') && (key <= '9') && PushInputEvent(&pendingInput, INPUT_DIGIT, key - '0', time)) sampled = true;
+    }
+
+    if (IsKeyPressed(KEY_BACKSPACE) && PushInputEvent(&pendingInput, INPUT_BACKSPACE, 0, time)) sampled = true;
+    if (IsKeyPressed(KEY_SPACE) && PushInputEvent(&pendingInput, INPUT_FIRE, 0, time)) sampled = true;
+    if (IsKeyPressed('P') && PushInputEvent(&pendingInput, INPUT_PAUSE, 0, time)) sampled = true;
+    if (IsKeyPressed(KEY_F5) && PushInputEvent(&pendingInput, INPUT_SAVE, 0, time)) sampled = true;
+    if (IsKeyPressed(KEY_F9) && PushInputEvent(&pendingInput, INPUT_LOAD, 0, time)) sampled = true;
+
+    if (sampled) pendingInput.sequence++;
+    sampledSequence = pendingInput.sequence;
+
+#if defined(SIMULATION_THREADED)
+    if (sampled)
+    {
+        simulationWake = true;
+        pthread_cond_signal(&inputSampled);
+    }
+
+    pthread_mutex_unlock(&inputMutex);
+#endif
+}
+
+// Simulation side: take everything sampled since the last tick
+static void TakeInput(InputQueue *input)
+{
+#if defined(SIMULATION_THREADED)
+    pthread_mutex_lock(&inputMutex);
+#endif
+
+    *input = pendingInput;
+
+    pendingInput.eventCount = 0;
+#if defined(SIMULATION_THREADED)
+    simulationWake = false;
+#endif
+
+#if defined(SIMULATION_THREADED)
+    pthread_mutex_unlock(&inputMutex);
+#endif
+}
+
+// Copy the state into the triple buffer back slot, the render thread never sees a partial update
+static void PublishGameState(unsigned int inputSequence)
+{
+    GameState *published = &gameState[GetTripleBufferWriteSlot(&stateBuffer)];
+    bool animating = !gameOver && !pause && (projectiles->count > 0);
+
+    if (sceneDirty || animating) stateVersion++;
+    sceneDirty = false;
+
+    published->version = stateVersion;
+    published->inputSequence = inputSequence;
+    published->match = matchNumber;
+    published->gameOver = gameOver;
+    published->pause = pause;
+    published->animating = animating;
+    published->botThinking = !gameOver && !pause && botThinking;
+    published->cursorBlinking = !gameOver && !pause && ((mouseOnText1 && (framesCounter1 < CURSOR_IDLE_FRAMES)) || (mouseOnText2 && (framesCounter2 < CURSOR_IDLE_FRAMES)));
+    published->mouseCursor = mouseCursor;
+    published->playerTurn = playerTurn;
+    published->worldWidth = worldWidth;
+
+    memcpy(published->player, player, sizeof(player));
+    memcpy(published->building, building, buildingCount*sizeof(Building));
+    published->buildingCount = buildingCount;
+    memcpy(published->explosion, explosion, sizeof(explosion));
+
+    for (int i = 0; i < projectiles->count; i++) published->projectile[i] = GetProjectilePosition(projectiles, i);
+    published->projectileCount = projectiles->count;
+
+    published->aim = aim;
+    published->mouseOnText1 = mouseOnText1;
+    published->mouseOnText2 = mouseOnText2;
+    published->framesCounter1 = framesCounter1;
+    published->framesCounter2 = framesCounter2;
+
+    published->explosionCount = explosionCount;
+    memcpy(published->explosionEvent, explosionEvent, sizeof(explosionEvent));
+
+    published->shotCount = shotCount;
+    published->shotKeyTime = shotKeyTime;
+    published->shotFireTime = shotFireTime;
+
+    PublishTripleBuffer(&stateBuffer);
+}
+
+static void MeasurePhotonLatency(void)
+{
+    // A shot that left the field before any frame showed it is skipped
+    if ((state->shotCount == measuredShots) || (state->projectileCount == 0) || state->gameOver) return;
+
+    double now = GetTime();
+
+    AddLatencySample(&photonLatency, now - state->shotKeyTime);
+    measuredShots = state->shotCount;
+
+    if (latencyLog != NULL)
+    {
+        fprintf(latencyLog, "%u,%.3f,%.3f,%.3f,%.3f\n", state->shotCount, 1000.0*(state->shotFireTime - state->shotKeyTime),
+                1000.0*(now - state->shotFireTime), 1000.0*(now - state->shotKeyTime), 1000.0*GetFrameTime());
+    }
+}
+
+static void UpdateParticleEffects(void)
+{
+    // Restart or load, the particles of the previous match are gone
+    if (state->match != particleMatch)
+    {
+        debris.count = 0;
+        smoke.count = 0;
+        particleMatch = state->match;
+        emittedExplosions = state->explosionCount;
+    }
+
+    // NOTE: Explosions of the states dropped by the triple buffer are still in the recent ones
+    unsigned int pending = state->explosionCount - emittedExplosions;
+    if (pending > MAX_EXPLOSION_EVENTS) pending = MAX_EXPLOSION_EVENTS;
+
+    for (unsigned int i = state->explosionCount - pending; i != state->explosionCount; i++) SpawnExplosionParticles(state->explosionEvent[i%MAX_EXPLOSION_EVENTS]);
+    emittedExplosions = state->explosionCount;
+
+    if (!state->gameOver && !state->pause)
+    {
+        float frameTime = GetFrameTime();
+        if (frameTime > MAX_FRAME_TIME) frameTime = MAX_FRAME_TIME;
+
+        UpdateParticles(&debris, frameTime);
+        UpdateParticles(&smoke, frameTime);
+    }
+}
+
+static void InitBuildings(const Level *level)
+{
+    buildingCount = level->buildingCount;
+    for (int i = 0; i < buildingCount; i++) building[i] = level->building[i];
+}
+
+static void InitPlayers(const Level *level)
 {
     for (int i = 0; i < MAX_PLAYERS; i++)
     {
@@ -501,27 +1196,14 @@ static void InitPlayers(void)
         if (i % 2 == 0) player[i].isLeftTeam = true;
         else player[i].isLeftTeam = false;
 
-        // Now there is no AI
-        player[i].isPlayer = true;
+        // Players without a bot are human
+        player[i].isPlayer = !IsBotPlayer(i);
 
         // Set size, by default by now
-        player[i].size = (Vector2){ 40, 40 };
-
-        // Set position
-        if (player[i].isLeftTeam) player[i].position.x = GetRandomValue(screenWidth*MIN_PLAYER_POSITION/100, screenWidth*MAX_PLAYER_POSITION/100);
-        else player[i].position.x = screenWidth - GetRandomValue(screenWidth*MIN_PLAYER_POSITION/100, screenWidth*MAX_PLAYER_POSITION/100);
+        player[i].size = (Vector2){ PLAYER_SIZE, PLAYER_SIZE };
 
-        for (int j = 0; j < MAX_BUILDINGS; j++)
-        {
-            if (building[j].rectangle.x > player[i].position.x)
-            {
-                // Set the player in the center of the building
-                player[i].position.x = building[j-1].rectangle.x + building[j-1].rectangle.width/2;
-                // Set the player at the top of the building
-                player[i].position.y = building[j-1].rectangle.y - player[i].size.y/2;
-                break;
-            }
-        }
+        // Set position, on top of a building
+        player[i].position = level->playerPosition[i];
 
         // Set statistics to 0
         player[i].aimingPoint.x = screenWidth/2;
@@ -535,159 +1217,358 @@ static void InitPlayers(void)
     }
 }
 
-static bool UpdatePlayer(int playerTurn)
+// Keystroke in the text box under the mouse, its value is updated along with the text
+static void UpdateAimField(const InputEvent *event)
 {
-    // Left team
-    if (player[playerTurn].isLeftTeam)
+    AimField *field = NULL;
+    int *framesCounter = NULL;
+
+    if (mouseOnText1)
     {
-        // Ball fired
-        if (IsKeyPressed(KEY_SPACE) && atoi(power) <= 300 && atoi(angle) <= 90 && atoi(power) != 0 && atoi(angle) != 0)
-        {
-            player[playerTurn].aimingPower = atoi(power);
-            
-            player[playerTurn].aimingAngle = atoi(angle);
+        field = &aim.power;
+        framesCounter = &framesCounter1;
+    }
+    else if (mouseOnText2)
+    {
+        field = &aim.angle;
+        framesCounter = &framesCounter2;
+    }
+    else return;
 
-            player[playerTurn].previousPower = player[playerTurn].aimingPower;
-            player[playerTurn].previousAngle = player[playerTurn].aimingAngle;
-            ball.position = player[playerTurn].position;
+    bool changed = (event->type == INPUT_DIGIT)? PushAimDigit(field, event->value) : PopAimDigit(field);
 
-            return true;
-        }
+    if (changed)
+    {
+        *framesCounter = 0;   // Restart blinking
+        sceneDirty = true;
     }
-    // Right team
-    else if (!player[playerTurn].isLeftTeam)
+}
+
+static bool UpdatePlayer(int playerTurn, const InputEvent *fire)
+{
+    // Ball fired, both teams aim the same way
+    if ((fire != NULL) && IsAimValid(&aim))
     {
-        // Ball fired
-        if (IsKeyPressed(KEY_SPACE) && atoi(power) <= 300 && atoi(angle) <= 90 && atoi(power) != 0 && atoi(angle) != 0)
-        {
-            player[playerTurn].aimingPower = atoi(power);
-            
-            player[playerTurn].aimingAngle = atoi(angle);
+        player[playerTurn].aimingPower = aim.power.value;
+        player[playerTurn].aimingAngle = aim.angle.value;
 
-            player[playerTurn].previousPower = player[playerTurn].aimingPower;
-            player[playerTurn].previousAngle = player[playerTurn].aimingAngle;
-            ball.position = player[playerTurn].position;
+        player[playerTurn].previousPower = player[playerTurn].aimingPower;
+        player[playerTurn].previousAngle = player[playerTurn].aimingAngle;
+        FireProjectile(playerTurn);
 
-            return true;
-        }
+        shotCount++;
+        shotKeyTime = fire->time;
+        shotFireTime = GetTime();
+        AddLatencySample(&fireLatency, shotFireTime - shotKeyTime);
+
+        return true;
+    }
+
+    return false;
+}
+
+// Hand the turn to the bot, then fire once it answered (or ran out of time)
+static bool UpdateBot(int playerTurn)
+{
+    if (!botThinking)
+    {
+        GameView view = { 0 };
+        GetGameView(playerTurn, &view);
+
+        RequestBotShot(playerTurn, &view);
+        botThinking = true;
+        WakeSimulation();   // Polled from the next tick on, even if the thread was about to go idle
+
+        return false;
+    }
+
+    int angle = 0;
+    int power = 0;
+
+    if (!PollBotShot(playerTurn, &angle, &power)) return false;
+
+    botThinking = false;
+
+    player[playerTurn].aimingAngle = angle;
+    player[playerTurn].aimingPower = power;
+    player[playerTurn].previousAngle = angle;
+    player[playerTurn].previousPower = power;
+    FireProjectile(playerTurn);
+
+    return true;
+}
+
+static void GetGameView(int playerTurn, GameView *view)
+{
+    BuildGameView(view, player, building, buildingCount, explosion, playerTurn, worldWidth, screenHeight);
+}
+
+static void FireProjectile(int playerTurn)
+{
+    // NOTE: A resumed match keeps the integration it was saved with
+    if (projectiles->fixedPoint)
+    {
+        int speedX = 0;
+        int speedY = 0;
+
+        GetFixedShotSpeed(player[playerTurn].previousAngle, player[playerTurn].previousPower, player[playerTurn].isLeftTeam, &speedX, &speedY);
+        SpawnFixedProjectile(projectiles, player[playerTurn].position, speedX, speedY, playerTurn);
     }
     else
     {
-        player[playerTurn].aimingPoint = player[playerTurn].position;
-        player[playerTurn].aimingPower = 0;
-        player[playerTurn].aimingAngle = 0;
+        Vector2 speed = { 0 };
+
+        speed.x = cos(player[playerTurn].previousAngle*DEG2RAD)*player[playerTurn].previousPower*3/DELTA_FPS;
+        speed.y = -sin(player[playerTurn].previousAngle*DEG2RAD)*player[playerTurn].previousPower*3/DELTA_FPS;
+
+        if (!player[playerTurn].isLeftTeam) speed.x = -speed.x;
+
+        SpawnProjectile(projectiles, player[playerTurn].position, speed, playerTurn);
     }
 
-    return false;
+    TrackShot(playerTurn);
+
+    ClearAimInput(&aim);
+
+    mouseOnText1 = false;
+    framesCounter1 = 0;
+
+    mouseOnText2 = false;
+    framesCounter2 = 0;
+}
+
+static void TrackShot(int playerTurn)
+{
+    flyingShot.seed = levelSeed;
+    flyingShot.turn = (uint16_t)matchTurn;
+    flyingShot.shooter = (uint8_t)playerTurn;
+    flyingShot.angle = (uint8_t)player[playerTurn].previousAngle;
+    flyingShot.power = (uint16_t)player[playerTurn].previousPower;
+    flyingShot.flightTicks = 0;
+    flyingShot.impactX = player[playerTurn].position.x;
+    flyingShot.impactY = player[playerTurn].position.y;
+    flyingShot.result = IMPACT_OUT;
+    flyingShot.target = -1;
+    flyingShot.fireFrameTime = 1000.0f*frameTime;
+    flyingShot.maxFrameTime = 1000.0f*frameTime;
+
+    trackingShot = true;
 }
 
-static bool UpdateBall(int playerTurn)
+static void LogLandedShot(void)
 {
-    static int explosionNumber = 0;
+    if (trackingShot) LogShot(&flyingShot);
 
-    // Activate ball
-    if (!ball.active)
+    trackingShot = false;
+    matchTurn++;
+}
+
+// Move every projectile in flight, returns true once the last one has collided
+static bool UpdateProjectiles(void)
+{
+    flyingShot.flightTicks++;
+    if (1000.0f*frameTime > flyingShot.maxFrameTime) flyingShot.maxFrameTime = 1000.0f*frameTime;
+
+    // NOTE: Iterate backwards so a removal only moves an already updated projectile into the freed slot
+    for (int i = projectiles->count - 1; i >= 0; i--)
     {
-        if (player[playerTurn].isLeftTeam)
-        {
-            ball.speed.x = cos(player[playerTurn].previousAngle*DEG2RAD)*player[playerTurn].previousPower*3/DELTA_FPS;
-            ball.speed.y = -sin(player[playerTurn].previousAngle*DEG2RAD)*player[playerTurn].previousPower*3/DELTA_FPS;
-            ball.active = true;
+        if (UpdateProjectile(i)) RemoveProjectile(projectiles, i);
+    }
 
-            for(int i = 0; i < MAX_INPUT_CHARS; i++)
-            {
-                power[i] = '\0';
-                angle[i] = '\0';
+    if (projectiles->fixedPoint) MoveFixedProjectiles(projectiles, FIXED_GRAVITY);
+    else MoveProjectiles(projectiles, GRAVITY/DELTA_FPS);
 
-                letterCount1 = 0;
-                mouseOnText1 = false;
-                framesCounter1 = 0;
+    return (projectiles->count == 0);
+}
 
-                letterCount2 = 0;
-                mouseOnText2 = false;
-                framesCounter2 = 0;
-            }
-        }
-        else
+// Sweep a single projectile along its next step, returns true if it must be removed
+static bool UpdateProjectile(int index)
+{
+    CollisionWorld world = GetCollisionWorld();
+    Vector2 start = GetProjectilePosition(projectiles, index);
+    Vector2 end = { start.x + projectiles->speedX[index], start.y + projectiles->speedY[index] };
+    int owner = projectiles->owner[index];
+
+    // Far from the terrain and the players this step cannot hit anything, only leaving the field has to be checked
+    float step = sqrtf(projectiles->speedX[index]*projectiles->speedX[index] + projectiles->speedY[index]*projectiles->speedY[index]);
+
+    if (GetShotClearance(terrain, &world, start, PROJECTILE_RADIUS, owner) > step)
+    {
+        bool out = (end.x + PROJECTILE_RADIUS < 0) || (end.x - PROJECTILE_RADIUS > worldWidth) || (end.y - PROJECTILE_RADIUS > screenHeight);
+        if (out)
         {
-            ball.speed.x = -cos(player[playerTurn].previousAngle*DEG2RAD)*player[playerTurn].previousPower*3/DELTA_FPS;
-            ball.speed.y = -sin(player[playerTurn].previousAngle*DEG2RAD)*player[playerTurn].previousPower*3/DELTA_FPS;
-            ball.active = true;
+            flyingShot.impactX = end.x;
+            flyingShot.impactY = end.y;
+        }
 
-            for(int i = 0; i < MAX_INPUT_CHARS; i++)
-            {
-                power[i] = '\0';
-                angle[i] = '\0';
+        return out;
+    }
 
-                letterCount1 = 0;
-                mouseOnText1 = false;
-                framesCounter1 = 0;
+    Impact impact = SweepProjectile(&world, start, end, PROJECTILE_RADIUS, owner);
 
-                letterCount2 = 0;
-                mouseOnText2 = false;
-                framesCounter2 = 0;
-            }
-        }
+    if (impact.type == IMPACT_NONE) return false;
+    else if (impact.type == IMPACT_OUT)
+    {
+        flyingShot.impactX = end.x;
+        flyingShot.impactY = end.y;
+        return true;
     }
 
-    ball.position.x += ball.speed.x;
-    ball.position.y += ball.speed.y;
-    ball.speed.y += GRAVITY/DELTA_FPS;
+    // We set the impact point
+    player[owner].impactPoint.x = impact.position.x;
+    player[owner].impactPoint.y = impact.position.y + PROJECTILE_RADIUS;
 
-    // Collision
-    if (ball.position.x + ball.radius < 0) return true;
-    else if (ball.position.x - ball.radius > screenWidth) return true;
-    else if (ball.position.y - ball.radius > screenHeight) return true;
+    flyingShot.impactX = player[owner].impactPoint.x;
+    flyingShot.impactY = player[owner].impactPoint.y;
+    flyingShot.result = (uint8_t)impact.type;
+    flyingShot.target = (impact.type == IMPACT_PLAYER)? (int8_t)impact.target : -1;
+
+    if (impact.type == IMPACT_PLAYER)
+    {
+        // We destroy the player
+        player[impact.target].isAlive = false;
+        QueueExplosionEffect(impact.position);
+    }
     else
     {
-        // Player collision
-        for (int i = 0; i < MAX_PLAYERS; i++)
-        {
-            if (CheckCollisionCircleRec(ball.position, ball.radius,  (Rectangle){ player[i].position.x - player[i].size.x/2, player[i].position.y - player[i].size.y/2,
-                                                                                  player[i].size.x, player[i].size.y }))
-            {
-                // We can't hit ourselves
-                if (i == playerTurn) return false;
-                else
-                {
-                    // We set the impact point
-                    player[playerTurn].impactPoint.x = ball.position.x;
-                    player[playerTurn].impactPoint.y = ball.position.y + ball.radius;
+        // We create an explosion, recycling the oldest one once all of them are in use
+        Explosion *crater = &explosion[explosionNumber];
+        Explosion recycled = *crater;
+
+        crater->position = player[owner].impactPoint;
+        crater->active = true;
+        explosionNumber = (explosionNumber + 1)%MAX_EXPLOSIONS;
+        QueueExplosionEffect(player[owner].impactPoint);
+
+        // Keep the terrain distance field in sync, a recycled crater is filled back in
+        if (recycled.active) UpdateTerrainFieldArea(terrain, &world, recycled.position, recycled.radius + TERRAIN_MAX_DISTANCE);
+        AddCraterToTerrainField(terrain, crater->position, crater->radius);
+    }
 
-                    // We destroy the player
-                    player[i].isAlive = false;
-                    return true;
-                }
-            }
-        }
+    return true;
+}
 
-        // Building collision
-        // NOTE: We only check building collision if we are not inside an explosion
-        for (int i = 0; i < MAX_EXPLOSIONS; i++)
-        {
-            if (CheckCollisionCircles(ball.position, ball.radius, explosion[i].position, explosion[i].radius - ball.radius))
-            {
-                return false;
-            }
-        }
+static void QueueExplosionEffect(Vector2 position)
+{
+    explosionEvent[explosionCount%MAX_EXPLOSION_EVENTS] = position;
+    explosionCount++;
+}
 
-        for (int i = 0; i < MAX_BUILDINGS; i++)
-        {
-            if (CheckCollisionCircleRec(ball.position, ball.radius, building[i].rectangle))
-            {
-                // We set the impact point
-                player[playerTurn].impactPoint.x = ball.position.x;
-                player[playerTurn].impactPoint.y = ball.position.y + ball.radius;
+static void SpawnExplosionParticles(Vector2 position)
+{
+    EmitParticles(&debris, position, EXPLOSION_DEBRIS_PARTICLES, 300.0f);
+    EmitParticles(&smoke, position, EXPLOSION_SMOKE_PARTICLES, 80.0f);
+}
 
-                // We create an explosion
-                explosion[explosionNumber].position = player[playerTurn].impactPoint;
-                explosion[explosionNumber].active = true;
-                explosionNumber++;
+static void SaveGame(void)
+{
+    static GameSnapshot snapshot = { 0 };
+
+    snapshot.levelSeed = levelSeed;
+    snapshot.playerTurn = playerTurn;
+    snapshot.explosionNumber = explosionNumber;
+    snapshot.gameOver = gameOver;
+    snapshot.pause = pause;
+    snapshot.worldWidth = worldWidth;
+    snapshot.buildingCount = buildingCount;
+
+    memcpy(snapshot.player, player, sizeof(player));
+    memcpy(snapshot.building, building, sizeof(building));
+    memcpy(snapshot.explosion, explosion, sizeof(explosion));
+    snapshot.projectiles = *projectiles;
+
+    memcpy(snapshot.power, aim.power.text, sizeof(aim.power.text));
+    memcpy(snapshot.angle, aim.angle.text, sizeof(aim.angle.text));
+    snapshot.letterCount1 = aim.power.length;
+    snapshot.letterCount2 = aim.angle.length;
+
+    // NOTE: Copied and written by the snapshot writer, the simulation does not wait for the disk
+    QueueSnapshot(SNAPSHOT_FILE_NAME, &snapshot);
+}
 
-                return true;
-            }
-        }
+static bool IsSnapshotInRange(const GameSnapshot *snapshot)
+{
+    if ((snapshot->playerTurn < 0) || (snapshot->playerTurn >= MAX_PLAYERS)) return false;
+    if ((snapshot->explosionNumber < 0) || (snapshot->explosionNumber >= MAX_EXPLOSIONS)) return false;
+    if ((snapshot->buildingCount < 0) || (snapshot->buildingCount > MAX_WORLD_BUILDINGS)) return false;
+    if ((snapshot->projectiles.count < 0) || (snapshot->projectiles.count > MAX_PROJECTILES)) return false;
+
+    for (int i = 0; i < snapshot->projectiles.count; i++)
+    {
+        if ((snapshot->projectiles.owner[i] < 0) || (snapshot->projectiles.owner[i] >= MAX_PLAYERS)) return false;
     }
 
-    return false;
-}
\ No newline at end of file
+    // Counts of characters, the text buffers also hold the terminator
+    if ((snapshot->letterCount1 < 0) || (snapshot->letterCount1 >= (int)sizeof(aim.power.text))) return false;
+    if ((snapshot->letterCount2 < 0) || (snapshot->letterCount2 >= (int)sizeof(aim.angle.text))) return false;
+
+    return true;
+}
+
+static bool LoadSavedGame(void)
+{
+    FlushSnapshots();
+
+    const GameSnapshot *snapshot = MapSnapshot(SNAPSHOT_FILE_NAME);
+
+    if (snapshot == NULL) return false;
+
+    // The terrain field was sized for this run's world
+    if ((snapshot->worldWidth != worldWidth) || (snapshot->buildingCount > MAX_WORLD_BUILDINGS))
+    {
+        TraceLog(LOG_WARNING, "GAME: Snapshot world is %i pixels wide, not %i [%s]", snapshot->worldWidth, worldWidth, SNAPSHOT_FILE_NAME);
+        UnmapSnapshot(snapshot);
+        return false;
+    }
+
+    // The checksum only catches accidents, every index copied into the live state is checked against its array
+    if (!IsSnapshotInRange(snapshot))
+    {
+        TraceLog(LOG_WARNING, "GAME: Snapshot indices or counts out of range [%s]", SNAPSHOT_FILE_NAME);
+        UnmapSnapshot(snapshot);
+        return false;
+    }
+
+    levelSeed = snapshot->levelSeed;
+    playerTurn = snapshot->playerTurn;
+    explosionNumber = snapshot->explosionNumber;
+    gameOver = snapshot->gameOver;
+    pause = snapshot->pause;
+
+    memcpy(player, snapshot->player, sizeof(player));
+    memcpy(building, snapshot->building, sizeof(building));
+    buildingCount = snapshot->buildingCount;
+    memcpy(explosion, snapshot->explosion, sizeof(explosion));
+    *projectiles = snapshot->projectiles;
+
+    // Who plays is decided by this run's bots, not by the saved one
+    for (int i = 0; i < MAX_PLAYERS; i++) player[i].isPlayer = !IsBotPlayer(i);
+
+    CancelBotShots();
+    botThinking = false;
+
+    // The telemetry turn count restarts, a shot resumed in flight was fired by another run and is not logged
+    matchTurn = 0;
+    trackingShot = false;
+
+    // The text is only parsed here, the digits go through the same path as keystrokes
+    ClearAimInput(&aim);
+    for (int i = 0; (i < snapshot->letterCount1) && (i < MAX_INPUT_CHARS); i++) PushAimDigit(&aim.power, snapshot->power[i] - '0');
+    for (int i = 0; (i < snapshot->letterCount2) && (i < MAX_INPUT_CHARS); i++) PushAimDigit(&aim.angle, snapshot->angle[i] - '0');
+
+    UnmapSnapshot(snapshot);
+
+    CollisionWorld world = GetCollisionWorld();
+    BuildTerrainField(terrain, &world);
+
+    // Particles are cosmetic and not saved, the render thread clears them on a new match
+    matchNumber++;
+    sceneDirty = true;
+
+    return true;
+}
+
+static CollisionWorld GetCollisionWorld(void)
+{
+    return (CollisionWorld){ building, buildingCount, explosion, MAX_EXPLOSIONS, player, MAX_PLAYERS, worldWidth, screenHeight };
+}
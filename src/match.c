@@ -0,0 +1,195 @@
+#include "match.h"
+
+#include "input.h"
+#include "projectile.h"
+#include "trajectory.h"
+
+#include <math.h>
+#include <stddef.h>
+
+void InitMatch(Match *match, const Level *level)
+{
+    // NOTE: Only the buildings of the level are written, clearing the whole world would cost more than the shots
+    match->seed = level->seed;
+    match->width = level->width;
+    match->height = level->height;
+    match->explosionNumber = 0;
+    match->playerTurn = 0;
+    match->turns = 0;
+    match->over = false;
+    match->winner = -1;
+
+    match->buildingCount = level->buildingCount;
+    for (int i = 0; i < level->buildingCount; i++) match->building[i] = level->building[i];
+
+    InitMatchPlayers(match->player, level);
+    InitMatchCraters(match->explosion);
+}
+
+void InitMatchPlayers(Player *player, const Level *level)
+{
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        player[i] = (Player){ 0 };
+        player[i].position = level->playerPosition[i];
+        player[i].size = (Vector2){ PLAYER_SIZE, PLAYER_SIZE };
+        player[i].isLeftTeam = ((i%2) == 0);
+        player[i].isPlayer = false;
+        player[i].isAlive = true;
+        player[i].impactPoint = (Vector2){ -100, -100 };
+    }
+}
+
+void InitMatchCraters(Explosion *explosion)
+{
+    for (int i = 0; i < MAX_EXPLOSIONS; i++) explosion[i] = (Explosion){ { 0.0f, 0.0f }, CRATER_RADIUS, false };
+}
+
+Vector2 GetShotSpeed(int angle, int power, bool leftTeam)
+{
+    Vector2 speed = { 0 };
+
+    speed.x = cos(angle*DEG2RAD)*power*3/DELTA_FPS;
+    speed.y = -sin(angle*DEG2RAD)*power*3/DELTA_FPS;
+
+    if (!leftTeam) speed.x = -speed.x;
+
+    return speed;
+}
+
+CollisionWorld GetMatchWorld(const Match *match)
+{
+    return (CollisionWorld){ match->building, match->buildingCount, match->explosion, MAX_EXPLOSIONS, match->player, MAX_PLAYERS, (float)match->width, (float)match->height };
+}
+
+Impact GetShotImpact(const CollisionWorld *world, const Player *player, int owner, int angle, int power)
+{
+    float tick = 0.0f;
+    Impact impact = SolveShot(world, player->position, GetShotSpeed(angle, power, player->isLeftTeam), PROJECTILE_RADIUS, owner, &tick);
+
+    if (tick > MATCH_MAX_SHOT_TICKS) impact.type = IMPACT_NONE;
+
+    return impact;
+}
+
+Impact PlayWorldShot(const CollisionWorld *world, Player *player, Explosion *explosion, int *explosionNumber, int shooter, int angle, int power)
+{
+    Player *self = &player[shooter];
+
+    self->previousAngle = angle;
+    self->previousPower = power;
+
+    Impact impact = GetShotImpact(world, self, shooter, angle, power);
+
+    if ((impact.type == IMPACT_PLAYER) || (impact.type == IMPACT_BUILDING))
+    {
+        // NOTE: Same impact point as UpdateProjectile(), at the bottom of the projectile
+        self->impactPoint = (Vector2){ impact.position.x, impact.position.y + PROJECTILE_RADIUS };
+
+        if (impact.type == IMPACT_PLAYER) player[impact.target].isAlive = false;
+        else
+        {
+            explosion[*explosionNumber].position = self->impactPoint;
+            explosion[*explosionNumber].active = true;
+            *explosionNumber = (*explosionNumber + 1)%MAX_EXPLOSIONS;
+        }
+    }
+
+    return impact;
+}
+
+bool IsMatchOver(const Player *player, int turns, int *winner)
+{
+    bool leftTeamAlive = false;
+    bool rightTeamAlive = false;
+
+    for (int i = 0; i < MAX_PLAYERS; i++)
+    {
+        if (player[i].isAlive)
+        {
+            if (player[i].isLeftTeam) leftTeamAlive = true;
+            else rightTeamAlive = true;
+        }
+    }
+
+    *winner = -1;
+
+    if (!leftTeamAlive || !rightTeamAlive)
+    {
+        *winner = leftTeamAlive? 0 : (rightTeamAlive? 1 : -1);
+        return true;
+    }
+
+    return (turns >= MATCH_MAX_TURNS);
+}
+
+Impact PlayMatchShot(Match *match, int angle, int power)
+{
+    CollisionWorld world = GetMatchWorld(match);
+    Impact impact = PlayWorldShot(&world, match->player, match->explosion, &match->explosionNumber, match->playerTurn, angle, power);
+
+    match->turns++;
+
+    if (IsMatchOver(match->player, match->turns, &match->winner)) match->over = true;
+    else match->playerTurn = (match->playerTurn + 1)%MAX_PLAYERS;
+
+    return impact;
+}
+
+void BuildGameView(GameView *view, const Player *player, const Building *building, int buildingCount, const Explosion *explosion, int self, int width, int height)
+{
+    view->apiVersion = BOT_API_VERSION;
+    view->width = width;
+    view->height = height;
+    view->gravity = GRAVITY/DELTA_FPS;
+    view->speedScale = 3.0f/DELTA_FPS;
+    view->projectileRadius = PROJECTILE_RADIUS;
+    view->maxAngle = MAX_AIM_ANGLE;
+    view->maxPower = MAX_AIM_POWER;
+
+    view->self = self;
+    view->previousAngle = player[self].previousAngle;
+    view->previousPower = player[self].previousPower;
+    view->impactX = player[self].impactPoint.x;
+    view->impactY = player[self].impactPoint.y;
+
+    view->playerCount = (MAX_PLAYERS < BOT_MAX_PLAYERS)? MAX_PLAYERS : BOT_MAX_PLAYERS;
+    for (int i = 0; i < view->playerCount; i++)
+    {
+        view->player[i].bounds = (BotRectangle){ player[i].position.x - player[i].size.x/2, player[i].position.y - player[i].size.y/2, player[i].size.x, player[i].size.y };
+        view->player[i].isAlive = player[i].isAlive;
+        view->player[i].isLeftTeam = player[i].isLeftTeam;
+    }
+
+    // Buildings around the middle of the players, all of them on a one screen world
+    float left = player[0].position.x;
+    float right = player[0].position.x;
+
+    for (int i = 1; i < MAX_PLAYERS; i++)
+    {
+        if (player[i].position.x < left) left = player[i].position.x;
+        if (player[i].position.x > right) right = player[i].position.x;
+    }
+
+    int first = FindFirstBuilding(building, buildingCount, (left + right)/2) - BOT_MAX_BUILDINGS/2;
+    if (first > buildingCount - BOT_MAX_BUILDINGS) first = buildingCount - BOT_MAX_BUILDINGS;
+    if (first < 0) first = 0;
+
+    view->buildingCount = (buildingCount < BOT_MAX_BUILDINGS)? buildingCount : BOT_MAX_BUILDINGS;
+    for (int i = 0; i < view->buildingCount; i++)
+    {
+        Rectangle rec = building[first + i].rectangle;
+        view->building[i] = (BotRectangle){ rec.x, rec.y, rec.width, rec.height };
+    }
+
+    view->craterCount = 0;
+    for (int i = 0; (i < MAX_EXPLOSIONS) && (view->craterCount < BOT_MAX_CRATERS); i++)
+    {
+        if (explosion[i].active) view->crater[view->craterCount++] = (BotCrater){ explosion[i].position.x, explosion[i].position.y, (float)explosion[i].radius };
+    }
+}
+
+void GetMatchView(const Match *match, GameView *view)
+{
+    BuildGameView(view, match->player, match->building, match->buildingCount, match->explosion, match->playerTurn, match->width, match->height);
+}
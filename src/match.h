@@ -0,0 +1,47 @@
+#ifndef MATCH_H
+#define MATCH_H
+
+#include "bot.h"
+#include "collision.h"
+#include "level.h"
+
+#define MATCH_MAX_TURNS                 200        // A match still running after that many shots is a draw
+#define MATCH_MAX_SHOT_TICKS           2000        // Longest flight, a shot still flying is lost
+#define CRATER_RADIUS                    30
+
+// Headless match with the rules of the game, no window and no per-tick loop: every shot is resolved at once.
+// Used by tools and bot tournaments, many matches can run side by side
+typedef struct Match {
+    unsigned int seed;
+    int width;
+    int height;
+    Player player[MAX_PLAYERS];
+    int buildingCount;
+    Building building[MAX_WORLD_BUILDINGS];
+    Explosion explosion[MAX_EXPLOSIONS];
+    int explosionNumber;                // Next crater slot, the oldest one is recycled
+    int playerTurn;
+    int turns;                          // Shots fired
+    bool over;
+    int winner;                         // Winning team: 0 left, 1 right, -1 for a draw or while running
+} Match;
+
+void InitMatch(Match *match, const Level *level);
+void InitMatchPlayers(Player *player, const Level *level);      // MAX_PLAYERS players, standing where the level puts them
+void InitMatchCraters(Explosion *explosion);                    // MAX_EXPLOSIONS inactive craters
+Vector2 GetShotSpeed(int angle, int power, bool leftTeam);     // Same launch speed as FireProjectile()
+CollisionWorld GetMatchWorld(const Match *match);
+Impact GetShotImpact(const CollisionWorld *world, const Player *player, int owner, int angle, int power);  // Resolved with SolveShot(), changes nothing
+Impact PlayMatchShot(Match *match, int angle, int power);      // Fire for the current player, apply the impact and pass the turn
+
+// The rules of a shot on any world layout: resolve it, then kill the player hit or dig the crater (recycling the oldest slot).
+// The world points into player and explosion, PlayMatchShot() and VecEnv both play through it
+Impact PlayWorldShot(const CollisionWorld *world, Player *player, Explosion *explosion, int *explosionNumber, int shooter, int angle, int power);
+bool IsMatchOver(const Player *player, int turns, int *winner);    // After a shot, winning team: 0 left, 1 right, -1 for a draw
+
+// Bot view of a game state, shared by the game and the headless matches
+// NOTE: Wider worlds only show the BOT_MAX_BUILDINGS buildings around the players
+void BuildGameView(GameView *view, const Player *player, const Building *building, int buildingCount, const Explosion *explosion, int self, int width, int height);
+void GetMatchView(const Match *match, GameView *view);         // For the player whose turn it is
+
+#endif // MATCH_H
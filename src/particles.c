@@ -0,0 +1,210 @@
+#include "particles.h"
+#include "rng.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__SSE__)
+    #include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+#define MESH_BUFFER_VERTICES              0        // Vertex buffer indices of UploadMesh()
+#define MESH_BUFFER_COLORS                3
+#define PARTICLE_TRANSFORM      (Matrix){ 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f }
+
+// NOTE: rlgl.h is not shipped in include/, this one is exported by raylib too
+void rlDrawRenderBatchActive(void);                     // Draw the queued render batch and reset it
+
+static Mesh particleMesh = { 0 };
+static Material particleMaterial = { 0 };
+
+void InitParticlePool(ParticlePool *pool, float lifetime, float gravity, float drag, float size, Color color)
+{
+    pool->count = 0;
+    pool->lifetime = lifetime;
+    pool->gravity = gravity;
+    pool->drag = drag;
+    pool->size = size;
+    pool->color = color;
+    pool->seed = 2463534242u;
+}
+
+int EmitParticles(ParticlePool *pool, Vector2 position, int count, float maxSpeed)
+{
+    if (count > MAX_PARTICLES - pool->count) count = MAX_PARTICLES - pool->count;
+
+    for (int i = pool->count; i < pool->count + count; i++)
+    {
+        float direction = RandomUnit(&pool->seed)*2*PI;
+        float speed = RandomUnit(&pool->seed)*maxSpeed;
+
+        pool->positionX[i] = position.x;
+        pool->positionY[i] = position.y;
+        pool->speedX[i] = cosf(direction)*speed;
+        pool->speedY[i] = sinf(direction)*speed;
+        pool->life[i] = pool->lifetime*(0.5f + 0.5f*RandomUnit(&pool->seed));
+    }
+
+    pool->count += count;
+
+    return count;
+}
+
+void UpdateParticles(ParticlePool *pool, float deltaTime)
+{
+    float damping = 1.0f - pool->drag*deltaTime;
+    float gravityStep = pool->gravity*deltaTime;
+
+    if (damping < 0.0f) damping = 0.0f;
+
+    float *positionX = pool->positionX;
+    float *positionY = pool->positionY;
+    float *speedX = pool->speedX;
+    float *speedY = pool->speedY;
+    float *life = pool->life;
+    int count = pool->count;
+    int i = 0;
+
+#if defined(__SSE__)
+    __m128 dampingVector = _mm_set1_ps(damping);
+    __m128 gravityVector = _mm_set1_ps(gravityStep);
+    __m128 deltaVector = _mm_set1_ps(deltaTime);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 sx = _mm_mul_ps(_mm_loadu_ps(speedX + i), dampingVector);
+        __m128 sy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(speedY + i), dampingVector), gravityVector);
+
+        _mm_storeu_ps(speedX + i, sx);
+        _mm_storeu_ps(speedY + i, sy);
+        _mm_storeu_ps(positionX + i, _mm_add_ps(_mm_loadu_ps(positionX + i), _mm_mul_ps(sx, deltaVector)));
+        _mm_storeu_ps(positionY + i, _mm_add_ps(_mm_loadu_ps(positionY + i), _mm_mul_ps(sy, deltaVector)));
+        _mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), deltaVector));
+    }
+#elif defined(__ARM_NEON)
+    float32x4_t dampingVector = vdupq_n_f32(damping);
+    float32x4_t gravityVector = vdupq_n_f32(gravityStep);
+    float32x4_t deltaVector = vdupq_n_f32(deltaTime);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t sx = vmulq_f32(vld1q_f32(speedX + i), dampingVector);
+        float32x4_t sy = vaddq_f32(vmulq_f32(vld1q_f32(speedY + i), dampingVector), gravityVector);
+
+        vst1q_f32(speedX + i, sx);
+        vst1q_f32(speedY + i, sy);
+        vst1q_f32(positionX + i, vaddq_f32(vld1q_f32(positionX + i), vmulq_f32(sx, deltaVector)));
+        vst1q_f32(positionY + i, vaddq_f32(vld1q_f32(positionY + i), vmulq_f32(sy, deltaVector)));
+        vst1q_f32(life + i, vsubq_f32(vld1q_f32(life + i), deltaVector));
+    }
+#endif
+
+    // Remaining particles (or all of them without SIMD support)
+    for (; i < count; i++)
+    {
+        speedX[i] *= damping;
+        speedY[i] = speedY[i]*damping + gravityStep;
+        positionX[i] += speedX[i]*deltaTime;
+        positionY[i] += speedY[i]*deltaTime;
+        life[i] -= deltaTime;
+    }
+
+    // Discard expired particles, moving the last live one into the freed slot
+    i = 0;
+    while (i < count)
+    {
+        if (life[i] <= 0.0f)
+        {
+            count--;
+            positionX[i] = positionX[count];
+            positionY[i] = positionY[count];
+            speedX[i] = speedX[count];
+            speedY[i] = speedY[count];
+            life[i] = life[count];
+        }
+        else i++;
+    }
+
+    pool->count = count;
+}
+
+int GetParticleVertices(const ParticlePool *pool, float *vertices, unsigned char *colors)
+{
+    float half = pool->size/2;
+    float fade = pool->color.a/pool->lifetime;
+
+    // Quad corners as two counter-clockwise triangles on screen: top-left, bottom-left, bottom-right and top-left, bottom-right, top-right
+    for (int i = 0; i < pool->count; i++)
+    {
+        float left = pool->positionX[i] - half;
+        float right = pool->positionX[i] + half;
+        float top = pool->positionY[i] - half;
+        float bottom = pool->positionY[i] + half;
+        float *vertex = vertices + i*PARTICLE_VERTICES*3;
+        Color color = { pool->color.r, pool->color.g, pool->color.b, (unsigned char)(pool->life[i]*fade) };
+
+        vertex[0] = left;   vertex[1] = top;       vertex[2] = 0.0f;
+        vertex[3] = left;   vertex[4] = bottom;    vertex[5] = 0.0f;
+        vertex[6] = right;  vertex[7] = bottom;    vertex[8] = 0.0f;
+        vertex[9] = left;   vertex[10] = top;      vertex[11] = 0.0f;
+        vertex[12] = right; vertex[13] = bottom;   vertex[14] = 0.0f;
+        vertex[15] = right; vertex[16] = top;      vertex[17] = 0.0f;
+
+        for (int v = 0; v < PARTICLE_VERTICES; v++) memcpy(colors + (i*PARTICLE_VERTICES + v)*4, &color, 4);
+    }
+
+    return pool->count*PARTICLE_VERTICES;
+}
+
+void LoadParticleMesh(void)
+{
+    if (particleMesh.vertices != NULL) return;
+
+    // NOTE: Buffers sized for full pools, every frame only the live part is rewritten and drawn, UnloadMesh() frees the CPU copies
+    particleMesh.vertexCount = MAX_DRAWN_POOLS*MAX_PARTICLES*PARTICLE_VERTICES;
+    particleMesh.triangleCount = particleMesh.vertexCount/3;
+    particleMesh.vertices = (float *)MemAlloc(particleMesh.vertexCount*3*sizeof(float));
+    particleMesh.colors = (unsigned char *)MemAlloc(particleMesh.vertexCount*4*sizeof(unsigned char));
+
+    UploadMesh(&particleMesh, true);
+    particleMaterial = LoadMaterialDefault();
+}
+
+void UnloadParticleMesh(void)
+{
+    if (particleMesh.vertices == NULL) return;
+
+    UnloadMesh(particleMesh);
+    UnloadMaterial(particleMaterial);
+    particleMesh = (Mesh){ 0 };
+}
+
+void DrawParticles(const ParticlePool *pools[], int poolCount)
+{
+    if (particleMesh.vertices == NULL) return;
+    if (poolCount > MAX_DRAWN_POOLS)
+    {
+        TraceLog(LOG_WARNING, "PARTICLES: %d pools drawn together, only the first %d fit", poolCount, MAX_DRAWN_POOLS);
+        poolCount = MAX_DRAWN_POOLS;
+    }
+
+    // Pools one after the other in the same buffers, later pools are drawn over the earlier ones
+    Mesh mesh = particleMesh;
+    mesh.vertexCount = 0;
+
+    for (int p = 0; p < poolCount; p++) mesh.vertexCount += GetParticleVertices(pools[p], mesh.vertices + mesh.vertexCount*3, mesh.colors + mesh.vertexCount*4);
+
+    if (mesh.vertexCount == 0) return;
+
+    mesh.triangleCount = mesh.vertexCount/3;
+
+    UpdateMeshBuffer(mesh, MESH_BUFFER_VERTICES, mesh.vertices, mesh.vertexCount*3*sizeof(float), 0);
+    UpdateMeshBuffer(mesh, MESH_BUFFER_COLORS, mesh.colors, mesh.vertexCount*4*sizeof(unsigned char), 0);
+
+    // The shapes queued so far are drawn first, the mesh does not go through the render batch
+    rlDrawRenderBatchActive();
+    DrawMesh(mesh, particleMaterial, PARTICLE_TRANSFORM);
+}
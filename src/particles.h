@@ -0,0 +1,37 @@
+#ifndef PARTICLES_H
+#define PARTICLES_H
+
+#include "raylib.h"
+
+#define MAX_PARTICLES                 65536
+#define PARTICLE_VERTICES                 6        // Two triangles per particle quad
+#define MAX_DRAWN_POOLS                   2        // Pools drawn together by DrawParticles()
+
+// Preallocated particle pool, stored as structure of arrays so the update runs 4 particles per SIMD instruction.
+// Every particle of a pool shares the same physics and look, live particles are packed in [0, count).
+typedef struct ParticlePool {
+    float positionX[MAX_PARTICLES];
+    float positionY[MAX_PARTICLES];
+    float speedX[MAX_PARTICLES];
+    float speedY[MAX_PARTICLES];
+    float life[MAX_PARTICLES];          // Seconds left before the particle expires
+    int count;                          // Number of live particles
+
+    float lifetime;                     // Maximum life of a particle in seconds
+    float gravity;                      // Vertical acceleration in pixels/s^2 (negative rises)
+    float drag;                         // Fraction of the speed lost per second
+    float size;                         // Side of the particle square in pixels
+    Color color;
+    unsigned int seed;                  // Emission random state
+} ParticlePool;
+
+void InitParticlePool(ParticlePool *pool, float lifetime, float gravity, float drag, float size, Color color);
+int EmitParticles(ParticlePool *pool, Vector2 position, int count, float maxSpeed);     // Returns the number of particles emitted
+void UpdateParticles(ParticlePool *pool, float deltaTime);                              // Integrate and discard expired particles
+int GetParticleVertices(const ParticlePool *pool, float *vertices, unsigned char *colors);   // Fill xyz and RGBA per vertex, returns the vertex count
+
+void LoadParticleMesh(void);                                                            // Load the GPU buffers shared by every pool
+void UnloadParticleMesh(void);
+void DrawParticles(const ParticlePool *pools[], int poolCount);                         // Draw the pools in order with one buffer update and one draw call
+
+#endif // PARTICLES_H
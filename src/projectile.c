@@ -0,0 +1,155 @@
+#include "projectile.h"
+#include "fixedpoint.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON)
+    #include <arm_neon.h>
+#endif
+
+void InitProjectilePool(ProjectilePool *pool)
+{
+    pool->count = 0;
+}
+
+int SpawnProjectile(ProjectilePool *pool, Vector2 position, Vector2 speed, int owner)
+{
+    if (pool->count >= MAX_PROJECTILES) return -1;
+
+    int index = pool->count;
+
+    pool->positionX[index] = position.x;
+    pool->positionY[index] = position.y;
+    pool->speedX[index] = speed.x;
+    pool->speedY[index] = speed.y;
+    pool->owner[index] = owner;
+    pool->count++;
+
+    return index;
+}
+
+int SpawnFixedProjectile(ProjectilePool *pool, Vector2 position, int speedX, int speedY, int owner)
+{
+    int index = SpawnProjectile(pool, position, (Vector2){ FixedToFloat(speedX), FixedToFloat(speedY) }, owner);
+
+    if (index >= 0)
+    {
+        pool->fixedPositionX[index] = FixedFromFloat(position.x);
+        pool->fixedPositionY[index] = FixedFromFloat(position.y);
+        pool->fixedSpeedX[index] = speedX;
+        pool->fixedSpeedY[index] = speedY;
+        pool->positionX[index] = FixedToFloat(pool->fixedPositionX[index]);
+        pool->positionY[index] = FixedToFloat(pool->fixedPositionY[index]);
+    }
+
+    return index;
+}
+
+void RemoveProjectile(ProjectilePool *pool, int index)
+{
+    int last = pool->count - 1;
+
+    if (index != last)
+    {
+        pool->positionX[index] = pool->positionX[last];
+        pool->positionY[index] = pool->positionY[last];
+        pool->speedX[index] = pool->speedX[last];
+        pool->speedY[index] = pool->speedY[last];
+        pool->fixedPositionX[index] = pool->fixedPositionX[last];
+        pool->fixedPositionY[index] = pool->fixedPositionY[last];
+        pool->fixedSpeedX[index] = pool->fixedSpeedX[last];
+        pool->fixedSpeedY[index] = pool->fixedSpeedY[last];
+        pool->owner[index] = pool->owner[last];
+    }
+
+    pool->count--;
+}
+
+void MoveProjectiles(ProjectilePool *pool, float gravity)
+{
+    float *positionX = pool->positionX;
+    float *positionY = pool->positionY;
+    const float *speedX = pool->speedX;
+    float *speedY = pool->speedY;
+    int count = pool->count;
+
+    // NOTE: Same integration order as a single ball: move first, then apply gravity
+    for (int i = 0; i < count; i++)
+    {
+        positionX[i] += speedX[i];
+        positionY[i] += speedY[i];
+        speedY[i] += gravity;
+    }
+}
+
+void MoveFixedProjectiles(ProjectilePool *pool, int gravity)
+{
+    int *fixedPositionX = pool->fixedPositionX;
+    int *fixedPositionY = pool->fixedPositionY;
+    const int *fixedSpeedX = pool->fixedSpeedX;
+    int *fixedSpeedY = pool->fixedSpeedY;
+    float *positionX = pool->positionX;
+    float *positionY = pool->positionY;
+    float *speedY = pool->speedY;
+    int count = pool->count;
+    int i = 0;
+
+    // NOTE: Integer adds give the same bits in any lane order, and int to float conversion
+    // rounds to nearest in SIMD and scalar code alike, scaling by a power of two is exact
+#if defined(__SSE2__)
+    __m128i gravityVector = _mm_set1_epi32(gravity);
+    __m128 scaleVector = _mm_set1_ps(1.0f/FIXED_ONE);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i sy = _mm_loadu_si128((const __m128i *)(fixedSpeedY + i));
+        __m128i px = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(fixedPositionX + i)), _mm_loadu_si128((const __m128i *)(fixedSpeedX + i)));
+        __m128i py = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(fixedPositionY + i)), sy);
+
+        sy = _mm_add_epi32(sy, gravityVector);
+
+        _mm_storeu_si128((__m128i *)(fixedPositionX + i), px);
+        _mm_storeu_si128((__m128i *)(fixedPositionY + i), py);
+        _mm_storeu_si128((__m128i *)(fixedSpeedY + i), sy);
+        _mm_storeu_ps(positionX + i, _mm_mul_ps(_mm_cvtepi32_ps(px), scaleVector));
+        _mm_storeu_ps(positionY + i, _mm_mul_ps(_mm_cvtepi32_ps(py), scaleVector));
+        _mm_storeu_ps(speedY + i, _mm_mul_ps(_mm_cvtepi32_ps(sy), scaleVector));
+    }
+#elif defined(__ARM_NEON)
+    int32x4_t gravityVector = vdupq_n_s32(gravity);
+    float32x4_t scaleVector = vdupq_n_f32(1.0f/FIXED_ONE);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        int32x4_t sy = vld1q_s32(fixedSpeedY + i);
+        int32x4_t px = vaddq_s32(vld1q_s32(fixedPositionX + i), vld1q_s32(fixedSpeedX + i));
+        int32x4_t py = vaddq_s32(vld1q_s32(fixedPositionY + i), sy);
+
+        sy = vaddq_s32(sy, gravityVector);
+
+        vst1q_s32(fixedPositionX + i, px);
+        vst1q_s32(fixedPositionY + i, py);
+        vst1q_s32(fixedSpeedY + i, sy);
+        vst1q_f32(positionX + i, vmulq_f32(vcvtq_f32_s32(px), scaleVector));
+        vst1q_f32(positionY + i, vmulq_f32(vcvtq_f32_s32(py), scaleVector));
+        vst1q_f32(speedY + i, vmulq_f32(vcvtq_f32_s32(sy), scaleVector));
+    }
+#endif
+
+    // Remaining projectiles (or all of them without SIMD support)
+    for (; i < count; i++)
+    {
+        fixedPositionX[i] += fixedSpeedX[i];
+        fixedPositionY[i] += fixedSpeedY[i];
+        fixedSpeedY[i] += gravity;
+
+        positionX[i] = FixedToFloat(fixedPositionX[i]);
+        positionY[i] = FixedToFloat(fixedPositionY[i]);
+        speedY[i] = FixedToFloat(fixedSpeedY[i]);
+    }
+}
+
+Vector2 GetProjectilePosition(const ProjectilePool *pool, int index)
+{
+    return (Vector2){ pool->positionX[index], pool->positionY[index] };
+}
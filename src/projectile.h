@@ -0,0 +1,34 @@
+#ifndef PROJECTILE_H
+#define PROJECTILE_H
+
+#include "raylib.h"
+
+#define MAX_PROJECTILES                 512
+#define PROJECTILE_RADIUS                10
+
+// Fixed-capacity projectile pool, stored as structure of arrays.
+// Active projectiles are always packed in [0, count), so every update only touches live entries.
+// NOTE: In fixed-point mode the Q16.16 arrays are the state and the float ones a copy of it, for collisions and drawing
+typedef struct ProjectilePool {
+    float positionX[MAX_PROJECTILES];
+    float positionY[MAX_PROJECTILES];
+    float speedX[MAX_PROJECTILES];
+    float speedY[MAX_PROJECTILES];
+    int fixedPositionX[MAX_PROJECTILES];
+    int fixedPositionY[MAX_PROJECTILES];
+    int fixedSpeedX[MAX_PROJECTILES];
+    int fixedSpeedY[MAX_PROJECTILES];
+    int owner[MAX_PROJECTILES];         // Index of the player that fired the projectile
+    int count;                          // Number of active projectiles
+    bool fixedPoint;                    // Deterministic integration, set while the pool is empty
+} ProjectilePool;
+
+void InitProjectilePool(ProjectilePool *pool);
+int SpawnProjectile(ProjectilePool *pool, Vector2 position, Vector2 speed, int owner);   // Returns the slot, -1 if the pool is full
+int SpawnFixedProjectile(ProjectilePool *pool, Vector2 position, int speedX, int speedY, int owner);  // Speed in Q16.16, fixed-point pools only
+void RemoveProjectile(ProjectilePool *pool, int index);                                  // Moves the last projectile into the freed slot
+void MoveProjectiles(ProjectilePool *pool, float gravity);                               // Integrate every active projectile one tick
+void MoveFixedProjectiles(ProjectilePool *pool, int gravity);                            // Same, bit-exact, gravity in Q16.16
+Vector2 GetProjectilePosition(const ProjectilePool *pool, int index);
+
+#endif // PROJECTILE_H
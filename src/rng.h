@@ -0,0 +1,49 @@
+#ifndef RNG_H
+#define RNG_H
+
+// Small xorshift random generator with explicit state.
+// NOTE: GetRandomValue() shares one global state, which is neither thread safe nor reproducible per level
+
+// Turn any seed (including 0) into a valid generator state
+static inline unsigned int SeedRandom(unsigned int seed)
+{
+    seed ^= seed >> 16;
+    seed *= 0x7feb352d;
+    seed ^= seed >> 15;
+    seed *= 0x846ca68b;
+    seed ^= seed >> 16;
+
+    return (seed != 0)? seed : 0x9e3779b9;
+}
+
+static inline unsigned int NextRandom(unsigned int *state)
+{
+    unsigned int x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+
+    return *state = x;
+}
+
+// Random float in [0, 1)
+static inline float RandomUnit(unsigned int *state)
+{
+    return (NextRandom(state) >> 8)*(1.0f/16777216.0f);
+}
+
+// Random int in [min, max], both included (like GetRandomValue())
+static inline int RandomRange(unsigned int *state, int min, int max)
+{
+    if (min > max)
+    {
+        int swap = min;
+        min = max;
+        max = swap;
+    }
+
+    return min + (int)(NextRandom(state)%((unsigned int)(max - min) + 1));
+}
+
+#endif // RNG_H
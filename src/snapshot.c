@@ -0,0 +1,231 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "snapshot.h"
+
+#include <fcntl.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #define SNAPSHOT_THREADED
+#endif
+
+#define SNAPSHOT_HEADER_SIZE      offsetof(GameSnapshot, levelSeed)
+#define SNAPSHOT_MAX_PATH               512
+
+// NOTE: The simulation copies into the pending buffer, the writer swaps it with its own under the lock and writes without it
+static GameSnapshot buffer[2] = { 0 };
+static GameSnapshot *writtenSnapshot = &buffer[1];
+static char writtenFileName[SNAPSHOT_MAX_PATH] = { 0 };
+
+#if defined(SNAPSHOT_THREADED)
+static GameSnapshot *pendingSnapshot = &buffer[0];
+static char pendingFileName[SNAPSHOT_MAX_PATH] = { 0 };
+static bool snapshotQueued = false;
+static bool snapshotWriting = false;
+
+static pthread_t writer;
+static pthread_mutex_t writerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writerSignal = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t writerIdle = PTHREAD_COND_INITIALIZER;
+static bool writerRunning = false;
+#endif
+
+static unsigned int GetChecksum(const GameSnapshot *snapshot)
+{
+    const unsigned char *data = (const unsigned char *)snapshot + SNAPSHOT_HEADER_SIZE;
+    unsigned int hash = 2166136261u;
+
+    for (size_t i = 0; i < sizeof(GameSnapshot) - SNAPSHOT_HEADER_SIZE; i++)
+    {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+bool SaveSnapshot(const char *fileName, GameSnapshot *snapshot)
+{
+    char tempName[512];
+    const char *data = (const char *)snapshot;
+    size_t written = 0;
+
+    snapshot->magic = SNAPSHOT_MAGIC;
+    snapshot->version = SNAPSHOT_VERSION;
+    snapshot->size = sizeof(GameSnapshot);
+    snapshot->checksum = GetChecksum(snapshot);
+
+    // NOTE: Written aside and renamed, a power cut leaves either the old or the new snapshot, never half of one
+    snprintf(tempName, sizeof(tempName), "%s.tmp", fileName);
+
+    int file = open(tempName, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (file < 0) return false;
+
+    while (written < sizeof(GameSnapshot))
+    {
+        ssize_t result = write(file, data + written, sizeof(GameSnapshot) - written);
+
+        if (result <= 0)
+        {
+            close(file);
+            unlink(tempName);
+            return false;
+        }
+
+        written += result;
+    }
+
+    bool success = (fsync(file) == 0);
+    close(file);
+
+    if (success) success = (rename(tempName, fileName) == 0);
+    if (!success) unlink(tempName);
+
+    return success;
+}
+
+// Write the snapshot that was swapped out of the queue
+static void WriteQueuedSnapshot(void)
+{
+    if (!SaveSnapshot(writtenFileName, writtenSnapshot)) TraceLog(LOG_WARNING, "SNAPSHOT: [%s] Failed to save", writtenFileName);
+}
+
+#if defined(SNAPSHOT_THREADED)
+static void *WriterLoop(void *data)
+{
+    (void)data;
+
+    pthread_mutex_lock(&writerMutex);
+
+    while (true)
+    {
+        while (writerRunning && !snapshotQueued) pthread_cond_wait(&writerSignal, &writerMutex);
+
+        if (!snapshotQueued) break;     // Stopped and everything is written
+
+        GameSnapshot *swap = pendingSnapshot;
+        pendingSnapshot = writtenSnapshot;
+        writtenSnapshot = swap;
+        memcpy(writtenFileName, pendingFileName, sizeof(writtenFileName));
+        snapshotQueued = false;
+        snapshotWriting = true;
+
+        // The file is written and synced without the lock, the simulation can queue the next snapshot meanwhile
+        pthread_mutex_unlock(&writerMutex);
+        WriteQueuedSnapshot();
+        pthread_mutex_lock(&writerMutex);
+
+        snapshotWriting = false;
+        pthread_cond_broadcast(&writerIdle);
+    }
+
+    pthread_mutex_unlock(&writerMutex);
+
+    return NULL;
+}
+#endif
+
+void QueueSnapshot(const char *fileName, const GameSnapshot *snapshot)
+{
+#if defined(SNAPSHOT_THREADED)
+    pthread_mutex_lock(&writerMutex);
+
+    if (!writerRunning)
+    {
+        writerRunning = true;
+
+        // Without a thread the snapshot is saved right away, like on the web
+        if (pthread_create(&writer, NULL, WriterLoop, NULL) != 0)
+        {
+            writerRunning = false;
+            TraceLog(LOG_WARNING, "SNAPSHOT: Failed to start the writer thread");
+        }
+    }
+
+    if (writerRunning)
+    {
+        memcpy(pendingSnapshot, snapshot, sizeof(GameSnapshot));
+        snprintf(pendingFileName, sizeof(pendingFileName), "%s", fileName);
+        snapshotQueued = true;
+        pthread_cond_signal(&writerSignal);
+        pthread_mutex_unlock(&writerMutex);
+        return;
+    }
+
+    pthread_mutex_unlock(&writerMutex);
+#endif
+
+    memcpy(writtenSnapshot, snapshot, sizeof(GameSnapshot));
+    snprintf(writtenFileName, sizeof(writtenFileName), "%s", fileName);
+    WriteQueuedSnapshot();
+}
+
+void FlushSnapshots(void)
+{
+#if defined(SNAPSHOT_THREADED)
+    pthread_mutex_lock(&writerMutex);
+    while (snapshotQueued || snapshotWriting) pthread_cond_wait(&writerIdle, &writerMutex);
+    pthread_mutex_unlock(&writerMutex);
+#endif
+}
+
+void CloseSnapshotWriter(void)
+{
+#if defined(SNAPSHOT_THREADED)
+    pthread_mutex_lock(&writerMutex);
+
+    if (!writerRunning)
+    {
+        pthread_mutex_unlock(&writerMutex);
+        return;
+    }
+
+    writerRunning = false;
+    pthread_cond_signal(&writerSignal);
+    pthread_mutex_unlock(&writerMutex);
+
+    // NOTE: The writer saves what is still queued before it leaves
+    pthread_join(writer, NULL);
+#endif
+}
+
+const GameSnapshot *MapSnapshot(const char *fileName)
+{
+    struct stat info;
+
+    int file = open(fileName, O_RDONLY);
+    if (file < 0) return NULL;
+
+    if ((fstat(file, &info) != 0) || (info.st_size != (off_t)sizeof(GameSnapshot)))
+    {
+        close(file);
+        return NULL;
+    }
+
+    void *data = mmap(NULL, sizeof(GameSnapshot), PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+
+    if (data == MAP_FAILED) return NULL;
+
+    const GameSnapshot *snapshot = (const GameSnapshot *)data;
+
+    if ((snapshot->magic != SNAPSHOT_MAGIC) || (snapshot->version != SNAPSHOT_VERSION) ||
+        (snapshot->size != sizeof(GameSnapshot)) || (snapshot->checksum != GetChecksum(snapshot)))
+    {
+        munmap(data, sizeof(GameSnapshot));
+        return NULL;
+    }
+
+    return snapshot;
+}
+
+void UnmapSnapshot(const GameSnapshot *snapshot)
+{
+    if (snapshot != NULL) munmap((void *)snapshot, sizeof(GameSnapshot));
+}
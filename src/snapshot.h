@@ -0,0 +1,48 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "gorilla.h"
+#include "projectile.h"
+
+#define SNAPSHOT_MAGIC           0x4c524f47        // "GORL"
+#define SNAPSHOT_VERSION                  3
+
+// Full game state with a fixed binary layout: the file is the struct, so a mapped file is used in place without parsing.
+// NOTE: The layout is the one of the build that wrote it, size and version reject files from other builds
+typedef struct GameSnapshot {
+    unsigned int magic;
+    unsigned int version;
+    unsigned int size;                  // sizeof(GameSnapshot)
+    unsigned int checksum;              // FNV-1a of everything after the header, catches torn or corrupted files
+
+    unsigned int levelSeed;
+    int playerTurn;
+    int explosionNumber;
+    bool gameOver;
+    bool pause;
+
+    int worldWidth;
+    int buildingCount;
+
+    Player player[MAX_PLAYERS];
+    Building building[MAX_WORLD_BUILDINGS];
+    Explosion explosion[MAX_EXPLOSIONS];
+    ProjectilePool projectiles;
+
+    char power[MAX_INPUT_CHARS + 1];
+    char angle[MAX_INPUT_CHARS + 1];
+    int letterCount1;
+    int letterCount2;
+} GameSnapshot;
+
+bool SaveSnapshot(const char *fileName, GameSnapshot *snapshot);   // Fills the header, replaces the file atomically
+
+// Background writer: the snapshot is copied and saved by a thread (synchronously on the web), queuing never waits for the disk.
+// A snapshot still queued when the next one comes is replaced by it, only the latest state is worth writing
+void QueueSnapshot(const char *fileName, const GameSnapshot *snapshot);
+void FlushSnapshots(void);          // Waits until the queued snapshot is on disk
+void CloseSnapshotWriter(void);     // Flushes and stops the writer thread
+const GameSnapshot *MapSnapshot(const char *fileName);             // Returns NULL if missing or invalid
+void UnmapSnapshot(const GameSnapshot *snapshot);
+
+#endif // SNAPSHOT_H
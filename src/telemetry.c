@@ -0,0 +1,237 @@
+#include "telemetry.h"
+
+#include "raylib.h"
+
+#include <stddef.h>
+
+#if !defined(PLATFORM_WEB)
+    #include <pthread.h>
+    #define TELEMETRY_THREADED
+#endif
+
+#define TELEMETRY_HEADER_SIZE     offsetof(TelemetryBlock, seed)
+
+typedef struct TelemetryColumn {
+    unsigned int flag;
+    size_t offset;
+    size_t size;                    // Bytes per shot
+} TelemetryColumn;
+
+// On-disk order of the columns
+static const TelemetryColumn columns[] = {
+    { TELEMETRY_SEED, offsetof(TelemetryBlock, seed), sizeof(uint32_t) },
+    { TELEMETRY_TURN, offsetof(TelemetryBlock, turn), sizeof(uint16_t) },
+    { TELEMETRY_SHOOTER, offsetof(TelemetryBlock, shooter), sizeof(uint8_t) },
+    { TELEMETRY_ANGLE, offsetof(TelemetryBlock, angle), sizeof(uint8_t) },
+    { TELEMETRY_POWER, offsetof(TelemetryBlock, power), sizeof(uint16_t) },
+    { TELEMETRY_FLIGHT_TICKS, offsetof(TelemetryBlock, flightTicks), sizeof(uint16_t) },
+    { TELEMETRY_IMPACT, offsetof(TelemetryBlock, impactX), sizeof(float) },
+    { TELEMETRY_IMPACT, offsetof(TelemetryBlock, impactY), sizeof(float) },
+    { TELEMETRY_RESULT, offsetof(TelemetryBlock, result), sizeof(uint8_t) },
+    { TELEMETRY_RESULT, offsetof(TelemetryBlock, target), sizeof(int8_t) },
+    { TELEMETRY_FRAME_TIME, offsetof(TelemetryBlock, fireFrameTime), sizeof(float) },
+    { TELEMETRY_FRAME_TIME, offsetof(TelemetryBlock, maxFrameTime), sizeof(float) },
+};
+
+#define TELEMETRY_COLUMNS         (sizeof(columns)/sizeof(columns[0]))
+
+// NOTE: The simulation fills block[filledBlocks%TELEMETRY_BLOCKS], the writer writes the ones up to filledBlocks.
+// Both counters only grow, each one is written by a single thread
+static FILE *telemetryFile = NULL;
+static TelemetryBlock block[TELEMETRY_BLOCKS] = { 0 };
+static unsigned int filledBlocks = 0;
+static unsigned int writtenBlocks = 0;
+static uint32_t fillCount = 0;           // Shots in the block being filled, its count is only set when it is submitted
+static unsigned int loggedShots = 0;
+static unsigned int droppedShots = 0;
+static bool writeFailed = false;
+
+#if defined(TELEMETRY_THREADED)
+static pthread_t writer;
+static pthread_mutex_t writerMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t writerSignal = PTHREAD_COND_INITIALIZER;
+static bool writerRunning = false;
+#endif
+
+static void WriteBlock(TelemetryBlock *data)
+{
+    bool success = (fwrite(data, TELEMETRY_HEADER_SIZE, 1, telemetryFile) == 1);
+
+    for (size_t i = 0; success && (i < TELEMETRY_COLUMNS); i++)
+    {
+        success = (fwrite((char *)data + columns[i].offset, columns[i].size, data->count, telemetryFile) == data->count);
+    }
+
+    if (success) success = (fflush(telemetryFile) == 0);
+
+    if (!success && !writeFailed)
+    {
+        TraceLog(LOG_WARNING, "TELEMETRY: Failed to write a block, the file is incomplete");
+        writeFailed = true;
+    }
+}
+
+#if defined(TELEMETRY_THREADED)
+static void *WriterLoop(void *data)
+{
+    (void)data;
+
+    pthread_mutex_lock(&writerMutex);
+
+    while (true)
+    {
+        while (writerRunning && (writtenBlocks == __atomic_load_n(&filledBlocks, __ATOMIC_ACQUIRE))) pthread_cond_wait(&writerSignal, &writerMutex);
+
+        unsigned int filled = __atomic_load_n(&filledBlocks, __ATOMIC_ACQUIRE);
+        if (writtenBlocks == filled) break;     // Stopped and everything is written
+
+        // The file is written without the lock, the simulation keeps filling the next block
+        pthread_mutex_unlock(&writerMutex);
+
+        for (unsigned int i = writtenBlocks; i != filled; i++) WriteBlock(&block[i%TELEMETRY_BLOCKS]);
+
+        pthread_mutex_lock(&writerMutex);
+        __atomic_store_n(&writtenBlocks, filled, __ATOMIC_RELEASE);
+    }
+
+    pthread_mutex_unlock(&writerMutex);
+
+    return NULL;
+}
+#endif
+
+// Hand the current block to the writer and start the next one
+static void SubmitBlock(void)
+{
+    block[filledBlocks%TELEMETRY_BLOCKS].count = fillCount;
+
+#if defined(TELEMETRY_THREADED)
+    pthread_mutex_lock(&writerMutex);
+    __atomic_store_n(&filledBlocks, filledBlocks + 1, __ATOMIC_RELEASE);
+    pthread_cond_signal(&writerSignal);
+    pthread_mutex_unlock(&writerMutex);
+#else
+    WriteBlock(&block[filledBlocks%TELEMETRY_BLOCKS]);
+    filledBlocks++;
+    writtenBlocks = filledBlocks;
+#endif
+
+    fillCount = 0;
+}
+
+bool OpenTelemetry(const char *fileName)
+{
+    if (telemetryFile != NULL) return false;
+
+    telemetryFile = fopen(fileName, "ab");
+
+    if (telemetryFile == NULL)
+    {
+        TraceLog(LOG_WARNING, "TELEMETRY: [%s] Failed to open", fileName);
+        return false;
+    }
+
+    for (int i = 0; i < TELEMETRY_BLOCKS; i++)
+    {
+        block[i].magic = TELEMETRY_MAGIC;
+        block[i].version = TELEMETRY_VERSION;
+    }
+
+    filledBlocks = 0;
+    writtenBlocks = 0;
+    fillCount = 0;
+    loggedShots = 0;
+    droppedShots = 0;
+    writeFailed = false;
+
+#if defined(TELEMETRY_THREADED)
+    writerRunning = true;
+
+    // Without a thread the blocks are written by the simulation, like on the web
+    if (pthread_create(&writer, NULL, WriterLoop, NULL) != 0)
+    {
+        fclose(telemetryFile);
+        telemetryFile = NULL;
+        writerRunning = false;
+        TraceLog(LOG_WARNING, "TELEMETRY: [%s] Failed to start the writer thread", fileName);
+        return false;
+    }
+#endif
+
+    TraceLog(LOG_INFO, "TELEMETRY: [%s] Logging shots", fileName);
+
+    return true;
+}
+
+void LogShot(const TelemetryShot *shot)
+{
+    if (telemetryFile == NULL) return;
+
+    // Every block is still queued: the disk is slower than the game, drop the shot instead of waiting
+    if (filledBlocks - __atomic_load_n(&writtenBlocks, __ATOMIC_ACQUIRE) >= TELEMETRY_BLOCKS)
+    {
+        droppedShots++;
+        return;
+    }
+
+    TelemetryBlock *current = &block[filledBlocks%TELEMETRY_BLOCKS];
+    uint32_t i = fillCount;
+
+    current->seed[i] = shot->seed;
+    current->turn[i] = shot->turn;
+    current->shooter[i] = shot->shooter;
+    current->angle[i] = shot->angle;
+    current->power[i] = shot->power;
+    current->flightTicks[i] = shot->flightTicks;
+    current->impactX[i] = shot->impactX;
+    current->impactY[i] = shot->impactY;
+    current->result[i] = shot->result;
+    current->target[i] = shot->target;
+    current->fireFrameTime[i] = shot->fireFrameTime;
+    current->maxFrameTime[i] = shot->maxFrameTime;
+    fillCount++;
+    loggedShots++;
+
+    if (fillCount == TELEMETRY_BLOCK_SHOTS) SubmitBlock();
+}
+
+void CloseTelemetry(void)
+{
+    if (telemetryFile == NULL) return;
+
+    if (fillCount > 0) SubmitBlock();
+
+#if defined(TELEMETRY_THREADED)
+    pthread_mutex_lock(&writerMutex);
+    writerRunning = false;
+    pthread_cond_signal(&writerSignal);
+    pthread_mutex_unlock(&writerMutex);
+
+    pthread_join(writer, NULL);
+#endif
+
+    fclose(telemetryFile);
+    telemetryFile = NULL;
+
+    TraceLog(LOG_INFO, "TELEMETRY: %u shots logged, %u dropped", loggedShots, droppedShots);
+}
+
+int ReadTelemetryBlock(FILE *file, TelemetryBlock *data, unsigned int wanted)
+{
+    size_t read = fread(data, 1, TELEMETRY_HEADER_SIZE, file);
+
+    if (read == 0) return 0;
+    if ((read != TELEMETRY_HEADER_SIZE) || (data->magic != TELEMETRY_MAGIC) || (data->version != TELEMETRY_VERSION) || (data->count > TELEMETRY_BLOCK_SHOTS)) return -1;
+
+    for (size_t i = 0; i < TELEMETRY_COLUMNS; i++)
+    {
+        // NOTE: Columns not requested are skipped without being read
+        if ((columns[i].flag & wanted) == 0)
+        {
+            if (fseek(file, (long)(columns[i].size*data->count), SEEK_CUR) != 0) return -1;
+        }
+        else if (fread((char *)data + columns[i].offset, columns[i].size, data->count, file) != data->count) return -1;
+    }
+
+    return (int)data->count;
+}
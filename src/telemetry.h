@@ -0,0 +1,70 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#define TELEMETRY_MAGIC          0x544f4853        // "SHOT"
+#define TELEMETRY_VERSION                 1
+#define TELEMETRY_BLOCK_SHOTS          4096        // Shots per block, a block is written at once
+#define TELEMETRY_BLOCKS                  4        // Blocks filled while the previous ones are written
+
+// Columns of a block, to read only the ones needed
+#define TELEMETRY_SEED             (1u << 0)
+#define TELEMETRY_TURN             (1u << 1)
+#define TELEMETRY_SHOOTER          (1u << 2)
+#define TELEMETRY_ANGLE            (1u << 3)
+#define TELEMETRY_POWER            (1u << 4)
+#define TELEMETRY_FLIGHT_TICKS     (1u << 5)
+#define TELEMETRY_IMPACT           (1u << 6)       // impactX and impactY
+#define TELEMETRY_RESULT           (1u << 7)       // result and target
+#define TELEMETRY_FRAME_TIME       (1u << 8)       // fireFrameTime and maxFrameTime
+#define TELEMETRY_ALL_COLUMNS        0x1ffu
+
+// One shot, as the game logs it
+typedef struct TelemetryShot {
+    uint32_t seed;                  // Level seed
+    uint16_t turn;                  // Shots fired in this match before this one
+    uint8_t shooter;
+    uint8_t angle;
+    uint16_t power;
+    uint16_t flightTicks;           // Simulation ticks from the launch to the impact
+    float impactX;                  // Impact point, or where the shot left the field
+    float impactY;
+    uint8_t result;                 // ImpactType (collision.h), IMPACT_OUT for a miss
+    int8_t target;                  // Player hit, -1 otherwise
+    float fireFrameTime;            // Milliseconds, render frame time when the shot was fired
+    float maxFrameTime;             // Milliseconds, longest render frame during the flight
+} TelemetryShot;
+
+// Append-only columnar file: a sequence of self-contained blocks, each one a header followed by every column in turn.
+// A scan reads or skips whole columns, files can be concatenated. NOTE: Native byte order, as written by the game
+typedef struct TelemetryBlock {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t count;
+    uint32_t seed[TELEMETRY_BLOCK_SHOTS];
+    uint16_t turn[TELEMETRY_BLOCK_SHOTS];
+    uint8_t shooter[TELEMETRY_BLOCK_SHOTS];
+    uint8_t angle[TELEMETRY_BLOCK_SHOTS];
+    uint16_t power[TELEMETRY_BLOCK_SHOTS];
+    uint16_t flightTicks[TELEMETRY_BLOCK_SHOTS];
+    float impactX[TELEMETRY_BLOCK_SHOTS];
+    float impactY[TELEMETRY_BLOCK_SHOTS];
+    uint8_t result[TELEMETRY_BLOCK_SHOTS];
+    int8_t target[TELEMETRY_BLOCK_SHOTS];
+    float fireFrameTime[TELEMETRY_BLOCK_SHOTS];
+    float maxFrameTime[TELEMETRY_BLOCK_SHOTS];
+} TelemetryBlock;
+
+// Writer: shots are added to a block in memory, full blocks are written by a background thread (synchronously on the web).
+// Logging a shot never allocates or blocks, shots that find every block still queued are dropped and counted
+bool OpenTelemetry(const char *fileName);   // Appends to the file
+void LogShot(const TelemetryShot *shot);    // Does nothing without an open file
+void CloseTelemetry(void);                  // Writes the last partial block
+
+// Reader: next block of the file, only the requested columns are filled. Returns the shot count, 0 at the end, -1 if invalid
+int ReadTelemetryBlock(FILE *file, TelemetryBlock *block, unsigned int columns);
+
+#endif // TELEMETRY_H
@@ -0,0 +1,264 @@
+#include "terrain.h"
+
+#include "jobs.h"
+
+#include <math.h>
+#include <stddef.h>
+
+typedef struct TerrainTask {
+    TerrainField *field;
+    const CollisionWorld *world;
+} TerrainTask;
+
+static float GetRecDistance(Rectangle rec, Vector2 point)
+{
+    float dx = fmaxf(rec.x - point.x, point.x - (rec.x + rec.width));
+    float dy = fmaxf(rec.y - point.y, point.y - (rec.y + rec.height));
+    float outside = sqrtf(fmaxf(dx, 0)*fmaxf(dx, 0) + fmaxf(dy, 0)*fmaxf(dy, 0));
+
+    return outside + fminf(fmaxf(dx, dy), 0);
+}
+
+static float ClampDistance(float distance)
+{
+    return fmaxf(-TERRAIN_MAX_DISTANCE, fminf(distance, TERRAIN_MAX_DISTANCE));
+}
+
+// NOTE: Buildings further than the clamp distance along x cannot change a sample, first is the first one that can
+static float GetBuildingDistance(const CollisionWorld *world, int first, Vector2 point)
+{
+    float buildings = TERRAIN_MAX_DISTANCE;
+
+    for (int i = first; (i < world->buildingCount) && (world->building[i].rectangle.x < point.x + TERRAIN_MAX_DISTANCE); i++)
+    {
+        buildings = fminf(buildings, GetRecDistance(world->building[i].rectangle, point));
+    }
+
+    return buildings;
+}
+
+static float GetExactDistance(const CollisionWorld *world, int first, Vector2 point)
+{
+    float buildings = GetBuildingDistance(world, first, point);
+    float craters = TERRAIN_MAX_DISTANCE;
+
+    for (int i = 0; i < world->explosionCount; i++)
+    {
+        if (!world->explosion[i].active) continue;
+
+        float dx = point.x - world->explosion[i].position.x;
+        float dy = point.y - world->explosion[i].position.y;
+        craters = fminf(craters, sqrtf(dx*dx + dy*dy) - world->explosion[i].radius);
+    }
+
+    // Difference of the two shapes
+    return ClampDistance(fmaxf(buildings, -craters));
+}
+
+int GetTerrainSampleCount(float width, float height)
+{
+    return ((int)(width/TERRAIN_CELL_SIZE) + 1)*((int)(height/TERRAIN_CELL_SIZE) + 1);
+}
+
+// Building samples of rows [start, end), each row walks the buildings once from left to right
+static void BuildTerrainRows(void *data, int start, int end)
+{
+    TerrainTask *task = (TerrainTask *)data;
+    TerrainField *field = task->field;
+    const CollisionWorld *world = task->world;
+
+    for (int row = start; row < end; row++)
+    {
+        int first = 0;
+
+        for (int column = 0; column < field->columns; column++)
+        {
+            Vector2 point = { (float)column*TERRAIN_CELL_SIZE, (float)row*TERRAIN_CELL_SIZE };
+
+            while ((first < world->buildingCount) && (world->building[first].rectangle.x + world->building[first].rectangle.width <= point.x - TERRAIN_MAX_DISTANCE)) first++;
+
+            field->distance[row*field->columns + column] = ClampDistance(GetBuildingDistance(world, first, point));
+        }
+    }
+}
+
+void BuildTerrainField(TerrainField *field, const CollisionWorld *world)
+{
+    TerrainTask task = { field, world };
+
+    field->width = world->width;
+    field->height = world->height;
+    field->columns = (int)(world->width/TERRAIN_CELL_SIZE) + 1;
+    field->rows = (int)(world->height/TERRAIN_CELL_SIZE) + 1;
+
+    // Buildings first, then every active crater carved locally: same samples as the exact distance, without every crater at every sample
+    ParallelFor(field->rows, TERRAIN_GRAIN, BuildTerrainRows, &task);
+
+    for (int i = 0; i < world->explosionCount; i++)
+    {
+        if (world->explosion[i].active) AddCraterToTerrainField(field, world->explosion[i].position, world->explosion[i].radius);
+    }
+}
+
+// Sample range covering a square around a point
+static void GetSampleRange(const TerrainField *field, Vector2 center, float radius, int *column0, int *row0, int *column1, int *row1)
+{
+    *column0 = (int)floorf((center.x - radius)/TERRAIN_CELL_SIZE);
+    *row0 = (int)floorf((center.y - radius)/TERRAIN_CELL_SIZE);
+    *column1 = (int)ceilf((center.x + radius)/TERRAIN_CELL_SIZE);
+    *row1 = (int)ceilf((center.y + radius)/TERRAIN_CELL_SIZE);
+
+    if (*column0 < 0) *column0 = 0;
+    if (*row0 < 0) *row0 = 0;
+    if (*column1 > field->columns - 1) *column1 = field->columns - 1;
+    if (*row1 > field->rows - 1) *row1 = field->rows - 1;
+}
+
+void UpdateTerrainFieldArea(TerrainField *field, const CollisionWorld *world, Vector2 center, float radius)
+{
+    int column0, row0, column1, row1;
+
+    GetSampleRange(field, center, radius, &column0, &row0, &column1, &row1);
+
+    int first = FindFirstBuilding(world->building, world->buildingCount, (float)column0*TERRAIN_CELL_SIZE - TERRAIN_MAX_DISTANCE);
+
+    for (int row = row0; row <= row1; row++)
+    {
+        for (int column = column0; column <= column1; column++)
+        {
+            field->distance[row*field->columns + column] = GetExactDistance(world, first, (Vector2){ (float)column*TERRAIN_CELL_SIZE, (float)row*TERRAIN_CELL_SIZE });
+        }
+    }
+}
+
+void AddCraterToTerrainField(TerrainField *field, Vector2 center, float radius)
+{
+    int column0, row0, column1, row1;
+
+    // NOTE: Removing a disc only raises samples to (radius - distance), which is below the clamp past radius + TERRAIN_MAX_DISTANCE
+    GetSampleRange(field, center, radius + TERRAIN_MAX_DISTANCE, &column0, &row0, &column1, &row1);
+
+    for (int row = row0; row <= row1; row++)
+    {
+        for (int column = column0; column <= column1; column++)
+        {
+            float dx = (float)column*TERRAIN_CELL_SIZE - center.x;
+            float dy = (float)row*TERRAIN_CELL_SIZE - center.y;
+            float inside = ClampDistance(radius - sqrtf(dx*dx + dy*dy));
+
+            if (inside > field->distance[row*field->columns + column]) field->distance[row*field->columns + column] = inside;
+        }
+    }
+}
+
+float GetTerrainClearance(const TerrainField *field, Vector2 position)
+{
+    // Everything solid is inside the field, so the distance to its bounds is already a lower bound
+    Vector2 clamped = { fmaxf(0, fminf(position.x, field->width)), fmaxf(0, fminf(position.y, field->height)) };
+    float outside = sqrtf((position.x - clamped.x)*(position.x - clamped.x) + (position.y - clamped.y)*(position.y - clamped.y));
+
+    int column = (int)(clamped.x/TERRAIN_CELL_SIZE + 0.5f);
+    int row = (int)(clamped.y/TERRAIN_CELL_SIZE + 0.5f);
+
+    if (column > field->columns - 1) column = field->columns - 1;
+    if (row > field->rows - 1) row = field->rows - 1;
+
+    // NOTE: Distance fields change at most 1 pixel per pixel, so the nearest sample minus the offset to it is a lower bound
+    float dx = position.x - (float)column*TERRAIN_CELL_SIZE;
+    float dy = position.y - (float)row*TERRAIN_CELL_SIZE;
+    float sampled = field->distance[row*field->columns + column] - sqrtf(dx*dx + dy*dy);
+
+    return fmaxf(outside, sampled);
+}
+
+float GetShotClearance(const TerrainField *field, const CollisionWorld *world, Vector2 position, float radius, int owner)
+{
+    float safe = GetTerrainClearance(field, position) - radius;
+
+    // Players are not part of the field
+    for (int i = 0; i < world->playerCount; i++)
+    {
+        Rectangle rec = { world->player[i].position.x - world->player[i].size.x/2, world->player[i].position.y - world->player[i].size.y/2,
+                          world->player[i].size.x, world->player[i].size.y };
+
+        // NOTE: While leaving the shooter collisions are masked, only exact sweeps handle that
+        if (i == owner)
+        {
+            if (GetRecDistance(rec, position) <= radius) return 0;
+        }
+        else if (world->player[i].isAlive) safe = fminf(safe, GetRecDistance(rec, position) - radius);
+    }
+
+    return safe;
+}
+
+static Vector2 GetShotPosition(Vector2 position, Vector2 speed, int tick)
+{
+    const float gravity = GRAVITY/DELTA_FPS;
+
+    return (Vector2){ position.x + tick*speed.x, position.y + tick*speed.y + gravity*tick*(tick - 1)/2 };
+}
+
+static bool IsOutOfField(const CollisionWorld *world, Vector2 position, float radius)
+{
+    return (position.x + radius < 0) || (position.x - radius > world->width) || (position.y - radius > world->height);
+}
+
+Impact MarchShot(const TerrainField *field, const CollisionWorld *world, Vector2 position, Vector2 speed, float radius, int owner, int maxTicks, float *tick)
+{
+    const float gravity = GRAVITY/DELTA_FPS;
+    Impact impact = { IMPACT_NONE, 1.0f, position, -1 };
+    int n = 0;
+
+    while (n < maxTicks)
+    {
+        Vector2 start = GetShotPosition(position, speed, n);
+        float safe = GetShotClearance(field, world, start, radius, owner);
+
+        // Ticks the shot surely stays inside the safe distance: k*|v| + g*k*(k - 1)/2 <= safe
+        int jump = 0;
+
+        if (safe > 0)
+        {
+            float velocity = sqrtf(speed.x*speed.x + (speed.y + gravity*n)*(speed.y + gravity*n));
+            float b = velocity - gravity/2;
+
+            jump = (int)((-b + sqrtf(b*b + 2*gravity*safe))/gravity);
+            if (n + jump > maxTicks) jump = maxTicks - n;
+        }
+
+        if (jump >= 2)
+        {
+            // Leaving the field never reverts, find the exact tick if it happened during the jump
+            if (IsOutOfField(world, GetShotPosition(position, speed, n + jump), radius))
+            {
+                int out = n + 1;
+                while (!IsOutOfField(world, GetShotPosition(position, speed, out), radius)) out++;
+
+                impact.type = IMPACT_OUT;
+                impact.position = GetShotPosition(position, speed, out);
+                if (tick != NULL) *tick = (float)out;
+
+                return impact;
+            }
+
+            n += jump;
+            continue;
+        }
+
+        // Close to something, sweep the next tick exactly
+        impact = SweepProjectile(world, start, GetShotPosition(position, speed, n + 1), radius, owner);
+
+        if (impact.type != IMPACT_NONE)
+        {
+            if (tick != NULL) *tick = n + impact.time;
+            return impact;
+        }
+
+        n++;
+    }
+
+    if (tick != NULL) *tick = (float)maxTicks;
+
+    return impact;
+}
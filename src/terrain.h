@@ -0,0 +1,31 @@
+#ifndef TERRAIN_H
+#define TERRAIN_H
+
+#include "collision.h"
+
+#define TERRAIN_CELL_SIZE                 4        // Pixels between distance samples
+#define TERRAIN_MAX_DISTANCE            128        // Distances are clamped, it bounds the area touched by a new crater
+#define TERRAIN_GRAIN                     8        // Rows per parallel range of BuildTerrainField()
+
+// Coarse signed distance field of the terrain (buildings minus craters), positive in the air.
+// Samples are max(building distance, -crater distance), so any query is a safe lower bound of the distance to something a shot can hit
+typedef struct TerrainField {
+    int columns;
+    int rows;
+    float width;
+    float height;
+    float *distance;                // [rows*columns], GetTerrainSampleCount() floats provided by the caller
+} TerrainField;
+
+int GetTerrainSampleCount(float width, float height);                                                           // Samples of a field covering the world
+void BuildTerrainField(TerrainField *field, const CollisionWorld *world);                                       // Rows spread over the job system
+void UpdateTerrainFieldArea(TerrainField *field, const CollisionWorld *world, Vector2 center, float radius);    // Recompute the samples around a point
+void AddCraterToTerrainField(TerrainField *field, Vector2 center, float radius);                                // Local update for a new crater
+float GetTerrainClearance(const TerrainField *field, Vector2 position);                                         // Lower bound of the distance to the terrain
+float GetShotClearance(const TerrainField *field, const CollisionWorld *world, Vector2 position, float radius, int owner);  // Distance a shot can move without hitting anything
+
+// Fly a shot jumping over every tick the field proves empty, sweeping exactly only close to the terrain or a player.
+// Same result as SimulateShot() with single tick steps
+Impact MarchShot(const TerrainField *field, const CollisionWorld *world, Vector2 position, Vector2 speed, float radius, int owner, int maxTicks, float *tick);
+
+#endif // TERRAIN_H
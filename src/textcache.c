@@ -0,0 +1,128 @@
+#include "textcache.h"
+
+#include <string.h>
+
+// Text layout cache entry, keyed by contents, size and color
+typedef struct CachedText {
+    char text[MAX_CACHED_TEXT_LENGTH + 1];
+    int fontSize;
+    Color color;                    // Only meaningful when hasTexture
+    int width;                      // MeasureText() result
+    bool hasTexture;
+    Texture2D texture;
+    unsigned int lastUse;           // For least recently used eviction
+    bool used;
+} CachedText;
+
+static CachedText cache[MAX_CACHED_TEXTS] = { 0 };
+static unsigned int useCounter = 0;
+
+static bool IsSameColor(Color a, Color b)
+{
+    return (a.r == b.r) && (a.g == b.g) && (a.b == b.b) && (a.a == b.a);
+}
+
+static CachedText *FindText(const char *text, int fontSize, const Color *color)
+{
+    for (int i = 0; i < MAX_CACHED_TEXTS; i++)
+    {
+        if (cache[i].used && (cache[i].fontSize == fontSize) && (strcmp(cache[i].text, text) == 0) &&
+            ((color == NULL) || (cache[i].hasTexture && IsSameColor(cache[i].color, *color))))
+        {
+            cache[i].lastUse = ++useCounter;
+            return &cache[i];
+        }
+    }
+
+    return NULL;
+}
+
+// Take a free entry, or the least recently used one
+static CachedText *AddText(const char *text, int fontSize)
+{
+    CachedText *entry = &cache[0];
+
+    for (int i = 0; i < MAX_CACHED_TEXTS; i++)
+    {
+        if (!cache[i].used)
+        {
+            entry = &cache[i];
+            break;
+        }
+
+        if (cache[i].lastUse < entry->lastUse) entry = &cache[i];
+    }
+
+    if (entry->hasTexture) UnloadTexture(entry->texture);
+
+    strcpy(entry->text, text);
+    entry->fontSize = fontSize;
+    entry->color = BLANK;
+    entry->width = MeasureText(text, fontSize);
+    entry->hasTexture = false;
+    entry->lastUse = ++useCounter;
+    entry->used = true;
+
+    return entry;
+}
+
+int MeasureTextCached(const char *text, int fontSize)
+{
+    if (strlen(text) > MAX_CACHED_TEXT_LENGTH) return MeasureText(text, fontSize);
+
+    CachedText *entry = FindText(text, fontSize, NULL);
+    if (entry == NULL) entry = AddText(text, fontSize);
+
+    return entry->width;
+}
+
+void DrawTextCached(const char *text, int posX, int posY, int fontSize, Color color)
+{
+#if TEXT_CACHE_TEXTURES
+    if ((text[0] == '\0') || (strlen(text) > MAX_CACHED_TEXT_LENGTH))
+    {
+        DrawText(text, posX, posY, fontSize, color);
+        return;
+    }
+
+    CachedText *entry = FindText(text, fontSize, &color);
+
+    if (entry == NULL)
+    {
+        // A string only measured so far is the single entry of its text and size, its texture is rendered there instead of caching it twice
+        entry = FindText(text, fontSize, NULL);
+        if ((entry == NULL) || entry->hasTexture) entry = AddText(text, fontSize);
+
+        // NOTE: Rendered on the CPU, a render texture could not be bound while the scene target is.
+        // Sizes multiple of the default font size are rendered at base size and scaled without filtering, to match DrawText()
+        int baseSize = GetFontDefault().baseSize;
+        Image image = { 0 };
+
+        if ((fontSize%baseSize) == 0)
+        {
+            image = ImageText(text, baseSize, color);
+            ImageResizeNN(&image, image.width*(fontSize/baseSize), image.height*(fontSize/baseSize));
+        }
+        else image = ImageText(text, fontSize, color);
+
+        entry->texture = LoadTextureFromImage(image);
+        entry->color = color;
+        entry->hasTexture = true;
+        UnloadImage(image);
+    }
+
+    DrawTexture(entry->texture, posX, posY, WHITE);
+#else
+    DrawText(text, posX, posY, fontSize, color);
+#endif
+}
+
+void UnloadTextCache(void)
+{
+    for (int i = 0; i < MAX_CACHED_TEXTS; i++)
+    {
+        if (cache[i].hasTexture) UnloadTexture(cache[i].texture);
+        cache[i].used = false;
+        cache[i].hasTexture = false;
+    }
+}
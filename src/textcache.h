@@ -0,0 +1,18 @@
+#ifndef TEXTCACHE_H
+#define TEXTCACHE_H
+
+#include "raylib.h"
+
+#define MAX_CACHED_TEXTS                 16
+#define MAX_CACHED_TEXT_LENGTH           32        // Longer strings are not cached
+
+// When enabled, every cached string is also pre-rendered into a texture and drawn as a single quad
+#ifndef TEXT_CACHE_TEXTURES
+    #define TEXT_CACHE_TEXTURES           1
+#endif
+
+int MeasureTextCached(const char *text, int fontSize);                              // Same as MeasureText(), measured once per string
+void DrawTextCached(const char *text, int posX, int posY, int fontSize, Color color); // Same as DrawText(), laid out once per string and color
+void UnloadTextCache(void);
+
+#endif // TEXTCACHE_H
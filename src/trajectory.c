@@ -0,0 +1,425 @@
+#include "trajectory.h"
+
+#include <float.h>
+#include <math.h>
+#include <stddef.h>
+
+#define MAX_SPANS                        16
+#define CRATER_SPANS                      2        // A parabola enters a disc at most twice
+#define DISC_SAMPLES                     16        // Sub-intervals searched for sign changes inside a disc window
+#define DISC_REFINEMENTS                 10        // Illinois steps refining a crossing, converges well before bisection would
+#define DISC_TOLERANCE                1e-4f        // Ticks, a crossing bracketed that tightly is refined enough
+
+// Shot position after s ticks: x(s) = x0 + vx*s, y(s) = y0 + b*s + a*s^2
+// NOTE: With a = g/2 and b = vy - g/2 it matches the per tick integration (move, then add gravity) at every integer s
+typedef struct Parabola {
+    float x0;
+    float y0;
+    float vx;
+    float a;
+    float b;
+} Parabola;
+
+// Ranges of s, each one [enter, exit]
+typedef struct SpanList {
+    float enter[MAX_SPANS];
+    float exit[MAX_SPANS];
+    int count;
+} SpanList;
+
+// Spans of every crater, solved the first time a contact falls near it
+typedef struct CraterCache {
+    float enter[MAX_EXPLOSIONS][CRATER_SPANS];
+    float exit[MAX_EXPLOSIONS][CRATER_SPANS];
+    int count[MAX_EXPLOSIONS];              // -1 until solved
+} CraterCache;
+
+static void AddSpan(SpanList *list, float enter, float exit)
+{
+    if ((enter > exit) || (list->count >= MAX_SPANS)) return;
+
+    list->enter[list->count] = enter;
+    list->exit[list->count] = exit;
+    list->count++;
+}
+
+static Vector2 GetParabolaPoint(const Parabola *path, float s)
+{
+    return (Vector2){ path->x0 + path->vx*s, path->y0 + path->b*s + path->a*s*s };
+}
+
+// Roots of a*s^2 + b*s + c = 0 with a > 0, returns false if there are none
+static bool SolveQuadratic(float a, float b, float c, float *low, float *high)
+{
+    float discriminant = b*b - 4*a*c;
+
+    if (discriminant < 0) return false;
+
+    float root = sqrtf(discriminant);
+
+    // NOTE: Numerically stable form, avoids cancellation when b*b >> 4*a*c
+    float q = (b >= 0)? -0.5f*(b + root) : -0.5f*(b - root);
+
+    if (q == 0)
+    {
+        *low = *high = 0;
+        return true;
+    }
+
+    float r0 = q/a;
+    float r1 = c/q;
+
+    *low = (r0 < r1)? r0 : r1;
+    *high = (r0 < r1)? r1 : r0;
+
+    return true;
+}
+
+// Spans where the shot position is inside an axis aligned box (at most two, the parabola may cross it twice)
+static void AddBoxSpans(const Parabola *path, float minX, float minY, float maxX, float maxY, SpanList *list)
+{
+    float xEnter = -FLT_MAX;
+    float xExit = FLT_MAX;
+
+    if (fabsf(path->vx) > 1e-6f)
+    {
+        xEnter = (minX - path->x0)/path->vx;
+        xExit = (maxX - path->x0)/path->vx;
+
+        if (xEnter > xExit)
+        {
+            float swap = xEnter;
+            xEnter = xExit;
+            xExit = swap;
+        }
+    }
+    else if ((path->x0 < minX) || (path->x0 > maxX)) return;
+
+    // y(s) <= maxY on a single range
+    float low, high;
+    if (!SolveQuadratic(path->a, path->b, path->y0 - maxY, &low, &high)) return;
+
+    if (low < xEnter) low = xEnter;
+    if (high > xExit) high = xExit;
+
+    // y(s) >= minY everywhere but between the two roots
+    float top0, top1;
+    if (!SolveQuadratic(path->a, path->b, path->y0 - minY, &top0, &top1)) AddSpan(list, low, high);
+    else
+    {
+        AddSpan(list, low, (high < top0)? high : top0);
+        AddSpan(list, (low > top1)? low : top1, high);
+    }
+}
+
+static float GetDiscDistance(const Parabola *path, Vector2 center, float radius, float s)
+{
+    Vector2 point = GetParabolaPoint(path, s);
+    float dx = point.x - center.x;
+    float dy = point.y - center.y;
+
+    return dx*dx + dy*dy - radius*radius;
+}
+
+// Spans where the shot position is inside a disc, within a box (the disc bounding box or a part of it)
+// NOTE: The distance is a quartic of s, its roots are bracketed inside the box spans, so the work is constant per disc
+static void AddDiscSpans(const Parabola *path, Vector2 center, float radius, Rectangle box, SpanList *list)
+{
+    SpanList windows = { 0 };
+
+    AddBoxSpans(path, box.x, box.y, box.x + box.width, box.y + box.height, &windows);
+
+    for (int w = 0; w < windows.count; w++)
+    {
+        float step = (windows.exit[w] - windows.enter[w])/DISC_SAMPLES;
+        float previous = windows.enter[w];
+        float previousDistance = GetDiscDistance(path, center, radius, previous);
+        bool inside = (previousDistance <= 0);
+        float enter = previous;
+
+        for (int i = 1; i <= DISC_SAMPLES; i++)
+        {
+            float current = (i == DISC_SAMPLES)? windows.exit[w] : windows.enter[w] + step*i;
+            float currentDistance = GetDiscDistance(path, center, radius, current);
+            bool currentInside = (currentDistance <= 0);
+
+            if (currentInside != inside)
+            {
+                // Refine the boundary crossing, the bracket keeps low on the side of the previous sample
+                float low = previous;
+                float high = current;
+                float lowDistance = previousDistance;
+                float highDistance = currentDistance;
+                int side = 0;
+
+                for (int j = 0; (j < DISC_REFINEMENTS) && (high - low > DISC_TOLERANCE); j++)
+                {
+                    float middle = (low*highDistance - high*lowDistance)/(highDistance - lowDistance);
+                    if (!((middle > low) && (middle < high))) middle = 0.5f*(low + high);
+
+                    float distance = GetDiscDistance(path, center, radius, middle);
+
+                    if ((distance <= 0) == inside)
+                    {
+                        low = middle;
+                        lowDistance = distance;
+                        if (side < 0) highDistance *= 0.5f;
+                        side = -1;
+                    }
+                    else
+                    {
+                        high = middle;
+                        highDistance = distance;
+                        if (side > 0) lowDistance *= 0.5f;
+                        side = 1;
+                    }
+                }
+
+                if (inside) AddSpan(list, enter, low);
+                else enter = high;
+
+                inside = currentInside;
+            }
+
+            previous = current;
+            previousDistance = currentDistance;
+        }
+
+        if (inside) AddSpan(list, enter, windows.exit[w]);
+    }
+}
+
+// Spans where a circle of the given radius touches a rectangle: rectangle grown by the radius, with rounded corners
+static void AddRoundedRecSpans(const Parabola *path, Rectangle rec, float radius, SpanList *list)
+{
+    SpanList pieces = { 0 };
+    SpanList outer = { 0 };
+
+    // Most rectangles are never near the path, the box grown by the radius on every side rejects them
+    AddBoxSpans(path, rec.x - radius, rec.y - radius, rec.x + rec.width + radius, rec.y + rec.height + radius, &outer);
+    if (outer.count == 0) return;
+
+    AddBoxSpans(path, rec.x - radius, rec.y, rec.x + rec.width + radius, rec.y + rec.height, &pieces);
+    AddBoxSpans(path, rec.x, rec.y - radius, rec.x + rec.width, rec.y + rec.height + radius, &pieces);
+
+    // Corners, the rest of each corner disc is inside the two boxes already
+    AddDiscSpans(path, (Vector2){ rec.x, rec.y }, radius, (Rectangle){ rec.x - radius, rec.y - radius, radius, radius }, &pieces);
+    AddDiscSpans(path, (Vector2){ rec.x + rec.width, rec.y }, radius, (Rectangle){ rec.x + rec.width, rec.y - radius, radius, radius }, &pieces);
+    AddDiscSpans(path, (Vector2){ rec.x, rec.y + rec.height }, radius, (Rectangle){ rec.x - radius, rec.y + rec.height, radius, radius }, &pieces);
+    AddDiscSpans(path, (Vector2){ rec.x + rec.width, rec.y + rec.height }, radius, (Rectangle){ rec.x + rec.width, rec.y + rec.height, radius, radius }, &pieces);
+
+    // Sort by enter time and merge the overlapping pieces
+    for (int i = 1; i < pieces.count; i++)
+    {
+        float enter = pieces.enter[i];
+        float exit = pieces.exit[i];
+        int j = i - 1;
+
+        while ((j >= 0) && (pieces.enter[j] > enter))
+        {
+            pieces.enter[j + 1] = pieces.enter[j];
+            pieces.exit[j + 1] = pieces.exit[j];
+            j--;
+        }
+
+        pieces.enter[j + 1] = enter;
+        pieces.exit[j + 1] = exit;
+    }
+
+    for (int i = 0; i < pieces.count; i++)
+    {
+        if ((list->count > 0) && (pieces.enter[i] <= list->exit[list->count - 1]))
+        {
+            if (pieces.exit[i] > list->exit[list->count - 1]) list->exit[list->count - 1] = pieces.exit[i];
+        }
+        else AddSpan(list, pieces.enter[i], pieces.exit[i]);
+    }
+}
+
+// First time in [from, until] inside one of the spans and outside every exclusion, -1 if there is none
+static float FindFirstContact(const SpanList *spans, const float *excludedEnter, const float *excludedExit, int excludedCount, float from, float until)
+{
+    for (int i = 0; i < spans->count; i++)
+    {
+        float time = (spans->enter[i] > from)? spans->enter[i] : from;
+        bool moved = true;
+
+        if (time > spans->exit[i]) continue;
+
+        while (moved)
+        {
+            moved = false;
+
+            for (int j = 0; j < excludedCount; j++)
+            {
+                if ((time >= excludedEnter[j]) && (time < excludedExit[j]))
+                {
+                    time = excludedExit[j];
+                    moved = true;
+                }
+            }
+        }
+
+        if (time > until) return -1;
+        if (time <= spans->exit[i]) return time;
+    }
+
+    return -1;
+}
+
+// End of the crater span covering the time, the time itself if no crater covers it
+static float SkipCrater(const Parabola *path, const CollisionWorld *world, CraterCache *cache, int craterCount, float time)
+{
+    Vector2 point = GetParabolaPoint(path, time);
+
+    for (int i = 0; i < craterCount; i++)
+    {
+        const Explosion *crater = &world->explosion[i];
+        float dx = point.x - crater->position.x;
+        float dy = point.y - crater->position.y;
+        float reach = crater->radius + 1.0f;
+
+        // A pixel of slack, the spans decide on the boundary
+        if (!crater->active || (dx*dx + dy*dy > reach*reach)) continue;
+
+        if (cache->count[i] < 0)
+        {
+            SpanList spans = { 0 };
+
+            AddDiscSpans(path, crater->position, crater->radius, (Rectangle){ crater->position.x - crater->radius, crater->position.y - crater->radius, 2*crater->radius, 2*crater->radius }, &spans);
+
+            cache->count[i] = 0;
+
+            for (int j = 0; (j < spans.count) && (cache->count[i] < CRATER_SPANS); j++)
+            {
+                cache->enter[i][cache->count[i]] = spans.enter[j];
+                cache->exit[i][cache->count[i]] = spans.exit[j];
+                cache->count[i]++;
+            }
+        }
+
+        for (int j = 0; j < cache->count[i]; j++)
+        {
+            if ((time >= cache->enter[i][j]) && (time < cache->exit[i][j])) return cache->exit[i][j];
+        }
+    }
+
+    return time;
+}
+
+static Rectangle GetPlayerRec(const Player *player)
+{
+    return (Rectangle){ player->position.x - player->size.x/2, player->position.y - player->size.y/2, player->size.x, player->size.y };
+}
+
+Impact SolveShot(const CollisionWorld *world, Vector2 position, Vector2 speed, float radius, int owner, float *tick)
+{
+    const float gravity = GRAVITY/DELTA_FPS;
+    Parabola path = { position.x, position.y, speed.x, gravity/2, speed.y - gravity/2 };
+    Impact impact = { IMPACT_OUT, 1.0f, position, -1 };
+    float low, high;
+
+    // Leaving the field is only checked at tick positions, the first tick strictly past the boundary
+    float outTime = FLT_MAX;
+
+    if (path.vx < 0) outTime = (-radius - path.x0)/path.vx;
+    else if (path.vx > 0) outTime = (world->width + radius - path.x0)/path.vx;
+
+    if (SolveQuadratic(path.a, path.b, path.y0 - radius - world->height, &low, &high) && (high < outTime)) outTime = high;
+
+    float outTick = floorf(outTime) + 1;
+    if (outTick < 1) outTick = 1;
+
+    // Exclusions: overlapping the shooter (for everything), craters are only checked at building contacts
+    SpanList ownerSpans = { 0 };
+    float excludedEnter[MAX_SPANS];
+    float excludedExit[MAX_SPANS];
+    int excludedCount = 0;
+
+    if (owner >= 0) AddRoundedRecSpans(&path, GetPlayerRec(&world->player[owner]), radius, &ownerSpans);
+
+    for (int i = 0; i < ownerSpans.count; i++)
+    {
+        excludedEnter[excludedCount] = ownerSpans.enter[i];
+        excludedExit[excludedCount] = ownerSpans.exit[i];
+        excludedCount++;
+    }
+
+    // Crater spans are solved the first time a contact falls inside one
+    int craterCount = (world->explosionCount < MAX_EXPLOSIONS)? world->explosionCount : MAX_EXPLOSIONS;
+    CraterCache craters;
+
+    for (int i = 0; i < craterCount; i++) craters.count[i] = -1;
+
+    float impactTime = outTick;
+
+    // Player collision
+    for (int i = 0; i < world->playerCount; i++)
+    {
+        SpanList spans = { 0 };
+
+        if ((i == owner) || !world->player[i].isAlive) continue;
+
+        AddRoundedRecSpans(&path, GetPlayerRec(&world->player[i]), radius, &spans);
+
+        float time = FindFirstContact(&spans, excludedEnter, excludedExit, excludedCount, 0, impactTime);
+
+        if (time >= 0)
+        {
+            impact.type = IMPACT_PLAYER;
+            impact.target = i;
+            impactTime = time;
+        }
+    }
+
+    // Building collision, only the ones under the flight until it leaves the field
+    float flightLeft = fminf(path.x0, path.x0 + path.vx*outTick) - radius - 1;
+    float flightRight = fmaxf(path.x0, path.x0 + path.vx*outTick) + radius + 1;
+
+    int first = FindFirstBuilding(world->building, world->buildingCount, flightLeft);
+    int last = FindFirstBuilding(world->building, world->buildingCount, flightRight);
+
+    if ((last >= world->buildingCount) || (world->building[last].rectangle.x > flightRight)) last--;
+
+    // In flight order, so the buildings past the first contact are never solved
+    for (int n = 0; n <= last - first; n++)
+    {
+        int i = (path.vx < 0)? last - n : first + n;
+        Rectangle rec = world->building[i].rectangle;
+        float impactX = path.x0 + path.vx*impactTime;
+        SpanList spans = { 0 };
+
+        if ((path.vx > 0) && (rec.x - radius > impactX)) break;
+        if ((path.vx < 0) && (rec.x + rec.width + radius < impactX)) break;
+
+        AddRoundedRecSpans(&path, world->building[i].rectangle, radius, &spans);
+
+        // The first contact outside the shooter, pushed past the craters covering it until one is not covered
+        float time = FindFirstContact(&spans, excludedEnter, excludedExit, excludedCount, 0, impactTime);
+
+        while (time >= 0)
+        {
+            float next = SkipCrater(&path, world, &craters, craterCount, time);
+
+            if (next == time) break;
+
+            time = FindFirstContact(&spans, excludedEnter, excludedExit, excludedCount, next, impactTime);
+        }
+
+        // NOTE: On a tie the player and then the leftmost building keep priority, as they do when sweeping step by step
+        if ((time >= 0) && ((time < impactTime) || (impact.type == IMPACT_OUT) || ((time == impactTime) && (impact.type == IMPACT_BUILDING) && (i < impact.target))))
+        {
+            impact.type = IMPACT_BUILDING;
+            impact.target = i;
+            impactTime = time;
+        }
+    }
+
+    impact.position = GetParabolaPoint(&path, impactTime);
+    impact.time = impactTime - ceilf(impactTime) + 1;
+    if (impactTime == 0) impact.time = 0;
+
+    if (tick != NULL) *tick = impactTime;
+
+    return impact;
+}
@@ -0,0 +1,54 @@
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include <stdbool.h>
+
+#define TRIPLE_BUFFER_FRESH            0x4         // Flag on the middle index: published and not acquired yet
+#define TRIPLE_BUFFER_INDEX            0x3         // Mask of the slot index
+
+// Lock-free single producer, single consumer triple buffer, only the slot indices are managed here.
+// The writer fills its back slot and swaps it with the middle one, the reader swaps its front slot
+// with the middle one when a fresh slot was published. Neither side ever waits for the other,
+// the reader always gets the latest complete slot and intermediate ones are dropped.
+typedef struct TripleBuffer {
+    int back;       // Owned by the writer
+    int middle;     // Shared, slot index plus TRIPLE_BUFFER_FRESH
+    int front;      // Owned by the reader
+} TripleBuffer;
+
+static inline void InitTripleBuffer(TripleBuffer *buffer)
+{
+    buffer->back = 0;
+    buffer->middle = 1;
+    buffer->front = 2;
+}
+
+// Slot the writer is allowed to fill
+static inline int GetTripleBufferWriteSlot(const TripleBuffer *buffer)
+{
+    return buffer->back;
+}
+
+// Slot the reader is allowed to read, it does not change until the next acquire
+static inline int GetTripleBufferReadSlot(const TripleBuffer *buffer)
+{
+    return buffer->front;
+}
+
+// Writer: make the back slot the latest one and get a free slot to fill next
+static inline void PublishTripleBuffer(TripleBuffer *buffer)
+{
+    buffer->back = __atomic_exchange_n(&buffer->middle, buffer->back | TRIPLE_BUFFER_FRESH, __ATOMIC_ACQ_REL) & TRIPLE_BUFFER_INDEX;
+}
+
+// Reader: switch to the latest published slot, returns false if nothing new was published
+static inline bool AcquireTripleBuffer(TripleBuffer *buffer)
+{
+    if ((__atomic_load_n(&buffer->middle, __ATOMIC_RELAXED) & TRIPLE_BUFFER_FRESH) == 0) return false;
+
+    buffer->front = __atomic_exchange_n(&buffer->middle, buffer->front, __ATOMIC_ACQ_REL) & TRIPLE_BUFFER_INDEX;
+
+    return true;
+}
+
+#endif // TRIPLEBUFFER_H
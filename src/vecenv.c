@@ -0,0 +1,229 @@
+#include "vecenv.h"
+
+#include "input.h"
+#include "jobs.h"
+#include "projectile.h"
+
+#include <math.h>
+
+typedef struct StepTask {
+    VecEnv *env;
+    const int *action;
+    float *reward;
+    unsigned char *done;
+} StepTask;
+
+typedef struct ObserveTask {
+    const VecEnv *env;
+    float *observation;
+} ObserveTask;
+
+bool InitVecEnv(VecEnv *env, int count)
+{
+    *env = (VecEnv){ 0 };
+
+    if (count < 1) return false;
+
+    size_t envSize = sizeof(unsigned int) + 3*sizeof(int) + MAX_PLAYERS*sizeof(Player) + MAX_BUILDINGS*sizeof(Building) + MAX_EXPLOSIONS*sizeof(Explosion);
+    if (!InitArena(&env->memory, (size_t)count*envSize + 7*ARENA_ALIGNMENT)) return false;
+
+    env->count = count;
+    env->episode = (unsigned int *)ArenaAlloc(&env->memory, count*sizeof(unsigned int));
+    env->playerTurn = (int *)ArenaAlloc(&env->memory, count*sizeof(int));
+    env->turns = (int *)ArenaAlloc(&env->memory, count*sizeof(int));
+    env->explosionNumber = (int *)ArenaAlloc(&env->memory, count*sizeof(int));
+    env->player = (Player *)ArenaAlloc(&env->memory, (size_t)count*MAX_PLAYERS*sizeof(Player));
+    env->building = (Building *)ArenaAlloc(&env->memory, (size_t)count*MAX_BUILDINGS*sizeof(Building));
+    env->explosion = (Explosion *)ArenaAlloc(&env->memory, (size_t)count*MAX_EXPLOSIONS*sizeof(Explosion));
+
+    return true;
+}
+
+void CloseVecEnv(VecEnv *env)
+{
+    CloseArena(&env->memory);
+    *env = (VecEnv){ 0 };
+}
+
+static CollisionWorld GetEnvWorld(const VecEnv *env, int index)
+{
+    return (CollisionWorld){ env->building + index*MAX_BUILDINGS, MAX_BUILDINGS, env->explosion + index*MAX_EXPLOSIONS, MAX_EXPLOSIONS,
+                             env->player + index*MAX_PLAYERS, MAX_PLAYERS, VEC_ENV_WIDTH, VEC_ENV_HEIGHT };
+}
+
+static void StartEpisode(VecEnv *env, int index)
+{
+    Level level;
+    unsigned int seed = env->seed + (unsigned int)index + env->episode[index]*(unsigned int)env->count;
+
+    // NOTE: A one-screen level always has MAX_BUILDINGS buildings, the slice holds them all
+    GenerateLevel(&level, seed, VEC_ENV_WIDTH, VEC_ENV_HEIGHT);
+
+    for (int i = 0; i < MAX_BUILDINGS; i++) env->building[index*MAX_BUILDINGS + i] = level.building[i];
+
+    InitMatchPlayers(env->player + index*MAX_PLAYERS, &level);
+    InitMatchCraters(env->explosion + index*MAX_EXPLOSIONS);
+    env->playerTurn[index] = 0;
+    env->turns[index] = 0;
+    env->explosionNumber[index] = 0;
+}
+
+static void ResetRange(void *data, int start, int end)
+{
+    VecEnv *env = (VecEnv *)data;
+
+    for (int i = start; i < end; i++)
+    {
+        env->episode[i] = 0;
+        StartEpisode(env, i);
+    }
+}
+
+void ResetVecEnv(VecEnv *env, unsigned int seed)
+{
+    env->seed = seed;
+    ParallelFor(env->count, VEC_ENV_GRAIN, ResetRange, env);
+}
+
+// Closest living opponent of the player, the closest one at all once they are all dead
+static int GetTarget(const Player *player, int self)
+{
+    int target = -1;
+    float closest = 0.0f;
+
+    for (int alive = 1; (alive >= 0) && (target < 0); alive--)
+    {
+        for (int i = 0; i < MAX_PLAYERS; i++)
+        {
+            if ((player[i].isLeftTeam == player[self].isLeftTeam) || (alive && !player[i].isAlive)) continue;
+
+            float distance = fabsf(player[i].position.x - player[self].position.x);
+
+            if ((target < 0) || (distance < closest))
+            {
+                target = i;
+                closest = distance;
+            }
+        }
+    }
+
+    return target;
+}
+
+// Reward of the shooter: 1 for an opponent hit, -1 for a teammate, otherwise minus the miss distance to the target over the width
+static float GetShotReward(const Player *player, int shooter, int target, Impact impact)
+{
+    if (impact.type == IMPACT_PLAYER) return (player[impact.target].isLeftTeam != player[shooter].isLeftTeam)? 1.0f : -1.0f;
+    if (impact.type != IMPACT_BUILDING) return VEC_ENV_MISS_REWARD;
+
+    Vector2 position = player[target].position;
+    float dx = impact.position.x - position.x;
+    float dy = impact.position.y + PROJECTILE_RADIUS - position.y;
+
+    return -fminf(sqrtf(dx*dx + dy*dy)/VEC_ENV_WIDTH, 1.0f);
+}
+
+static void StepRange(void *data, int start, int end)
+{
+    StepTask *task = (StepTask *)data;
+    VecEnv *env = task->env;
+
+    for (int i = start; i < end; i++)
+    {
+        CollisionWorld world = GetEnvWorld(env, i);
+        Player *player = env->player + i*MAX_PLAYERS;
+        int shooter = env->playerTurn[i];
+        int target = GetTarget(player, shooter);
+        int angle = task->action[2*i];
+        int power = task->action[2*i + 1];
+        int winner = -1;
+
+        // Out of range actions are clamped, like text boxes that cannot hold more digits
+        if (angle < 1) angle = 1;
+        if (angle > MAX_AIM_ANGLE) angle = MAX_AIM_ANGLE;
+        if (power < 1) power = 1;
+        if (power > MAX_AIM_POWER) power = MAX_AIM_POWER;
+
+        // Same turn as PlayMatchShot()
+        Impact impact = PlayWorldShot(&world, player, env->explosion + i*MAX_EXPLOSIONS, &env->explosionNumber[i], shooter, angle, power);
+        bool over = IsMatchOver(player, ++env->turns[i], &winner);
+
+        task->reward[i] = GetShotReward(player, shooter, target, impact);
+        task->done[i] = over;
+
+        if (over)
+        {
+            env->episode[i]++;
+            StartEpisode(env, i);
+        }
+        else env->playerTurn[i] = (shooter + 1)%MAX_PLAYERS;
+    }
+}
+
+void StepVecEnv(VecEnv *env, const int *action, float *reward, unsigned char *done)
+{
+    StepTask task = { env, action, reward, done };
+    ParallelFor(env->count, VEC_ENV_GRAIN, StepRange, &task);
+}
+
+static void ObserveRange(void *data, int start, int end)
+{
+    ObserveTask *task = (ObserveTask *)data;
+
+    for (int i = start; i < end; i++)
+    {
+        const VecEnv *env = task->env;
+        const Player *player = env->player + i*MAX_PLAYERS;
+        const Building *buildings = env->building + i*MAX_BUILDINGS;
+        const Explosion *explosions = env->explosion + i*MAX_EXPLOSIONS;
+        float *observation = task->observation + (size_t)i*VEC_ENV_OBSERVATION_SIZE;
+        const Player *self = &player[env->playerTurn[i]];
+        const Player *target = &player[GetTarget(player, env->playerTurn[i])];
+
+        // The right team is mirrored, it shoots to the left
+        float width = (float)VEC_ENV_WIDTH;
+        float height = (float)VEC_ENV_HEIGHT;
+        float mirror = self->isLeftTeam? 0.0f : 1.0f;
+        float sign = self->isLeftTeam? 1.0f : -1.0f;
+
+        observation[VEC_ENV_SELF] = mirror + sign*self->position.x/width;
+        observation[VEC_ENV_SELF + 1] = self->position.y/height;
+        observation[VEC_ENV_TARGET] = mirror + sign*target->position.x/width;
+        observation[VEC_ENV_TARGET + 1] = target->position.y/height;
+        observation[VEC_ENV_PREVIOUS_SHOT] = (float)self->previousAngle/MAX_AIM_ANGLE;
+        observation[VEC_ENV_PREVIOUS_SHOT + 1] = (float)self->previousPower/MAX_AIM_POWER;
+
+        // The impact point starts off the field
+        bool impacted = (self->impactPoint.x >= 0.0f);
+        observation[VEC_ENV_PREVIOUS_IMPACT] = impacted? mirror + sign*self->impactPoint.x/width : -1.0f;
+        observation[VEC_ENV_PREVIOUS_IMPACT + 1] = impacted? self->impactPoint.y/height : -1.0f;
+        observation[VEC_ENV_TURN] = (float)env->turns[i]/MATCH_MAX_TURNS;
+
+        for (int b = 0; b < MAX_BUILDINGS; b++)
+        {
+            Rectangle rec = buildings[b].rectangle;
+            float *building = observation + VEC_ENV_BUILDINGS + 4*b;
+
+            building[0] = self->isLeftTeam? rec.x/width : 1.0f - (rec.x + rec.width)/width;
+            building[1] = rec.y/height;
+            building[2] = rec.width/width;
+            building[3] = rec.height/height;
+        }
+
+        for (int c = 0; c < VEC_ENV_CRATERS; c++)
+        {
+            const Explosion *explosion = &explosions[(env->explosionNumber[i] - 1 - c + MAX_EXPLOSIONS)%MAX_EXPLOSIONS];
+            float *crater = observation + VEC_ENV_CRATER_LIST + 3*c;
+
+            crater[0] = explosion->active? mirror + sign*explosion->position.x/width : 0.0f;
+            crater[1] = explosion->active? explosion->position.y/height : 0.0f;
+            crater[2] = explosion->active? 1.0f : 0.0f;
+        }
+    }
+}
+
+void ObserveVecEnv(const VecEnv *env, float *observation)
+{
+    ObserveTask task = { env, observation };
+    ParallelFor(env->count, VEC_ENV_GRAIN, ObserveRange, &task);
+}
@@ -0,0 +1,52 @@
+#ifndef VECENV_H
+#define VECENV_H
+
+#include "arena.h"
+#include "match.h"
+
+#include <stdbool.h>
+
+#define VEC_ENV_WIDTH                   800        // Field of the game window
+#define VEC_ENV_HEIGHT                  450
+#define VEC_ENV_CRATERS                  16        // Most recent craters in an observation
+#define VEC_ENV_GRAIN                    32        // Environments per parallel range
+#define VEC_ENV_MISS_REWARD          -1.00f        // Shot that left the field
+
+// Observation of the player to act, mirrored for the right team so every policy shoots to the right.
+// Positions are divided by the field width or height, angle and power by their maximum
+#define VEC_ENV_SELF                      0        // x, y of the shooter center
+#define VEC_ENV_TARGET                    2        // x, y of the closest living opponent
+#define VEC_ENV_PREVIOUS_SHOT             4        // angle, power
+#define VEC_ENV_PREVIOUS_IMPACT           6        // x, y, negative before the first impact
+#define VEC_ENV_TURN                      8        // Shots fired over MATCH_MAX_TURNS
+#define VEC_ENV_BUILDINGS                 9        // x, y, width, height of every building
+#define VEC_ENV_CRATER_LIST      (VEC_ENV_BUILDINGS + 4*MAX_BUILDINGS)    // x, y, active of the newest craters first
+#define VEC_ENV_OBSERVATION_SIZE (VEC_ENV_CRATER_LIST + 3*VEC_ENV_CRATERS)
+
+// Batch of K headless matches stepped in lockstep, for shot policy training: no window, no per-step allocation.
+// Every call fills caller-provided contiguous buffers, env i at [i*size], straight from the match state.
+// Per-env counters are arrays over the batch, the worlds are one-screen slices (about 3.7 KB per env, a Match holds room
+// for the widest world): env i owns player[i*MAX_PLAYERS], building[i*MAX_BUILDINGS] and explosion[i*MAX_EXPLOSIONS].
+// The rules are the ones of PlayMatchShot(), played through PlayWorldShot() on a CollisionWorld over the slices.
+// A finished match is reset at once with its next seed, its done flag tells the caller about it.
+// NOTE: Steps are spread over the job system (ParallelFor), run inline if InitJobSystem() was not called
+typedef struct VecEnv {
+    int count;
+    unsigned int seed;                  // Seed of the last reset, match i of episode e uses seed + i + e*count
+    unsigned int *episode;              // [count] Matches finished since the reset
+    int *playerTurn;                    // [count]
+    int *turns;                         // [count] Shots fired in the current match
+    int *explosionNumber;               // [count] Next crater slot, the oldest one is recycled
+    Player *player;                     // [count*MAX_PLAYERS]
+    Building *building;                 // [count*MAX_BUILDINGS]
+    Explosion *explosion;               // [count*MAX_EXPLOSIONS]
+    Arena memory;                       // Everything above, allocated once
+} VecEnv;
+
+bool InitVecEnv(VecEnv *env, int count);                    // The only heap allocation of the batch
+void CloseVecEnv(VecEnv *env);
+void ResetVecEnv(VecEnv *env, unsigned int seed);           // Restart every match
+void StepVecEnv(VecEnv *env, const int *action, float *reward, unsigned char *done);   // action[2*i] angle, action[2*i + 1] power
+void ObserveVecEnv(const VecEnv *env, float *observation);  // VEC_ENV_OBSERVATION_SIZE floats per env
+
+#endif // VECENV_H
@@ -0,0 +1,317 @@
+// Impact heatmap: where shots land over many matches, to spot a bias of the level generation (buildings and player positions).
+// Impacts come from headless matches of random shots, or from telemetry files written with --telemetry, the ones beyond the field
+// of one screen (games played with --world-screens) are reported apart from the grid and its counts.
+// Usage: heatmap [--games <n>] [--seed <n>] [--telemetry <file.shots>]... [--png <file.png>] [--raw <file.raw>]
+// NOTE: Every thread counts into its own histogram, they are only merged at the end, there is no shared counter
+#define _POSIX_C_SOURCE 200809L
+
+#include "input.h"
+#include "jobs.h"
+#include "match.h"
+#include "projectile.h"
+#include "telemetry.h"
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define FIELD_WIDTH                     800
+#define FIELD_HEIGHT                    450
+#define DEFAULT_GAMES                 10000
+#define GAME_GRAIN                       64        // Matches per parallel range
+#define SHOT_MAX_POWER                  150        // Random shots, stronger ones mostly leave the field
+#define READ_BLOCKS                      16        // Telemetry blocks read, then counted in parallel
+#define MAX_HISTOGRAMS       (MAX_JOB_WORKERS + 1) // Workers and the calling thread
+
+typedef struct ImpactCounts {
+    unsigned int building;
+    unsigned int player;
+    unsigned int out;
+    unsigned int beyond;            // Building or player impacts outside the grid, wider worlds of --world-screens telemetry
+} ImpactCounts;
+
+// One histogram per thread, claimed by the first impact a thread counts
+typedef struct ThreadHistogram {
+    unsigned int cell[FIELD_HEIGHT][FIELD_WIDTH];
+    ImpactCounts counts;
+} ThreadHistogram;
+
+static ThreadHistogram *histogram[MAX_HISTOGRAMS] = { 0 };
+static int histogramCount = 0;
+static __thread ThreadHistogram *threadHistogram = NULL;
+
+static ThreadHistogram merged = { 0 };
+static unsigned int baseSeed = 1;
+static TelemetryBlock readBlock[READ_BLOCKS];
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+static ThreadHistogram *GetThreadHistogram(void)
+{
+    if (threadHistogram == NULL)
+    {
+        int index = __atomic_fetch_add(&histogramCount, 1, __ATOMIC_RELAXED);
+
+        threadHistogram = (ThreadHistogram *)calloc(1, sizeof(ThreadHistogram));
+        if (threadHistogram == NULL) abort();
+
+        histogram[index] = threadHistogram;
+    }
+
+    return threadHistogram;
+}
+
+static void CountImpact(ThreadHistogram *counts, int type, float x, float y)
+{
+    if (type == IMPACT_OUT)
+    {
+        counts->counts.out++;
+        return;
+    }
+
+    if ((type != IMPACT_PLAYER) && (type != IMPACT_BUILDING)) return;
+
+    int cellX = (int)floorf(x);
+    int cellY = (int)floorf(y);
+
+    // NOTE: Counted apart, the building and player totals and the left/right split only cover the impacts of the grid
+    if ((cellX < 0) || (cellX >= FIELD_WIDTH))
+    {
+        counts->counts.beyond++;
+        return;
+    }
+
+    // Building sides are hit a little below the bottom edge, through craters that reach it, they go to the last row
+    if (cellY < 0) cellY = 0;
+    else if (cellY >= FIELD_HEIGHT) cellY = FIELD_HEIGHT - 1;
+
+    if (type == IMPACT_PLAYER) counts->counts.player++;
+    else counts->counts.building++;
+
+    counts->cell[cellY][cellX]++;
+}
+
+// Xorshift, every match has its own sequence so the result does not depend on the thread count
+static unsigned int NextRandom(unsigned int *state)
+{
+    unsigned int x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+static void PlayGames(void *data, int start, int end)
+{
+    (void)data;
+
+    ThreadHistogram *counts = GetThreadHistogram();
+    Level level = { 0 };
+    Match match = { 0 };
+
+    for (int i = start; i < end; i++)
+    {
+        unsigned int seed = baseSeed + (unsigned int)i;
+        unsigned int random = seed*2654435761u | 1;
+
+        GenerateLevel(&level, seed, FIELD_WIDTH, FIELD_HEIGHT);
+        InitMatch(&match, &level);
+
+        while (!match.over)
+        {
+            int angle = 1 + NextRandom(&random)%MAX_AIM_ANGLE;
+            int power = 1 + NextRandom(&random)%SHOT_MAX_POWER;
+
+            Impact impact = PlayMatchShot(&match, angle, power);
+
+            // Same impact point as the game, at the bottom of the projectile
+            CountImpact(counts, impact.type, impact.position.x, impact.position.y + PROJECTILE_RADIUS);
+        }
+    }
+}
+
+static void CountBlocks(void *data, int start, int end)
+{
+    (void)data;
+
+    ThreadHistogram *counts = GetThreadHistogram();
+
+    for (int b = start; b < end; b++)
+    {
+        const TelemetryBlock *block = &readBlock[b];
+
+        for (unsigned int i = 0; i < block->count; i++) CountImpact(counts, block->result[i], block->impactX[i], block->impactY[i]);
+    }
+}
+
+static bool ReadTelemetry(const char *fileName)
+{
+    FILE *file = fopen(fileName, "rb");
+
+    if (file == NULL)
+    {
+        fprintf(stderr, "%s: cannot open\n", fileName);
+        return false;
+    }
+
+    bool valid = true;
+
+    while (valid)
+    {
+        int blocks = 0;
+
+        while (blocks < READ_BLOCKS)
+        {
+            int count = ReadTelemetryBlock(file, &readBlock[blocks], TELEMETRY_IMPACT | TELEMETRY_RESULT);
+
+            if (count < 0) valid = false;
+            if (count <= 0) break;
+
+            blocks++;
+        }
+
+        if (blocks == 0) break;
+
+        ParallelFor(blocks, 1, CountBlocks, NULL);
+    }
+
+    if (!valid) fprintf(stderr, "%s: invalid block, the rest of the file is skipped\n", fileName);
+
+    fclose(file);
+
+    return valid;
+}
+
+static void MergeHistograms(void)
+{
+    for (int h = 0; h < histogramCount; h++)
+    {
+        const ThreadHistogram *counts = histogram[h];
+
+        for (int y = 0; y < FIELD_HEIGHT; y++)
+        {
+            for (int x = 0; x < FIELD_WIDTH; x++) merged.cell[y][x] += counts->cell[y][x];
+        }
+
+        merged.counts.building += counts->counts.building;
+        merged.counts.player += counts->counts.player;
+        merged.counts.out += counts->counts.out;
+        merged.counts.beyond += counts->counts.beyond;
+
+        free(histogram[h]);
+        histogram[h] = NULL;
+    }
+}
+
+// Black to red to yellow to white, on a log scale so rare impacts stay visible
+static bool ExportHeatmap(const char *fileName)
+{
+    static Color pixel[FIELD_HEIGHT][FIELD_WIDTH];
+    unsigned int maxCount = 0;
+
+    for (int y = 0; y < FIELD_HEIGHT; y++)
+    {
+        for (int x = 0; x < FIELD_WIDTH; x++) if (merged.cell[y][x] > maxCount) maxCount = merged.cell[y][x];
+    }
+
+    float scale = (maxCount > 0)? 1.0f/logf(1.0f + maxCount) : 0.0f;
+
+    for (int y = 0; y < FIELD_HEIGHT; y++)
+    {
+        for (int x = 0; x < FIELD_WIDTH; x++)
+        {
+            float heat = logf(1.0f + merged.cell[y][x])*scale*3.0f;
+
+            float red = fminf(heat, 1.0f);
+            float green = fminf(fmaxf(heat - 1.0f, 0.0f), 1.0f);
+            float blue = fminf(fmaxf(heat - 2.0f, 0.0f), 1.0f);
+
+            pixel[y][x] = (Color){ (unsigned char)(255*red), (unsigned char)(255*green), (unsigned char)(255*blue), 255 };
+        }
+    }
+
+    Image image = { pixel, FIELD_WIDTH, FIELD_HEIGHT, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+
+    return ExportImage(image, fileName);
+}
+
+// Row-major grid of FIELD_WIDTH x FIELD_HEIGHT 32-bit counts, native byte order
+static bool ExportRawHeatmap(const char *fileName)
+{
+    FILE *file = fopen(fileName, "wb");
+    if (file == NULL) return false;
+
+    bool success = (fwrite(merged.cell, sizeof(merged.cell), 1, file) == 1);
+
+    return (fclose(file) == 0) && success;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *pngFile = NULL;
+    const char *rawFile = NULL;
+    const char *telemetryFile[64] = { 0 };
+    int telemetryCount = 0;
+    int games = -1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--games") == 0) && (i + 1 < argc)) games = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc)) baseSeed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if ((strcmp(argv[i], "--telemetry") == 0) && (i + 1 < argc) && (telemetryCount < 64)) telemetryFile[telemetryCount++] = argv[++i];
+        else if ((strcmp(argv[i], "--png") == 0) && (i + 1 < argc)) pngFile = argv[++i];
+        else if ((strcmp(argv[i], "--raw") == 0) && (i + 1 < argc)) rawFile = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: %s [--games <n>] [--seed <n>] [--telemetry <file.shots>]... [--png <file.png>] [--raw <file.raw>]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    // Simulated matches unless only telemetry files are given
+    if (games < 0) games = (telemetryCount > 0)? 0 : DEFAULT_GAMES;
+    if ((pngFile == NULL) && (rawFile == NULL)) pngFile = "heatmap.png";
+
+    SetTraceLogLevel(LOG_WARNING);
+    InitJobSystem(-1, false);
+
+    double start = GetMilliseconds();
+
+    if (games > 0) ParallelFor(games, GAME_GRAIN, PlayGames, NULL);
+    for (int i = 0; i < telemetryCount; i++) ReadTelemetry(telemetryFile[i]);
+
+    double elapsed = GetMilliseconds() - start;
+
+    CloseJobSystem();
+    MergeHistograms();
+
+    unsigned int impacts = merged.counts.building + merged.counts.player;
+    unsigned int left = 0;
+
+    for (int y = 0; y < FIELD_HEIGHT; y++)
+    {
+        for (int x = 0; x < FIELD_WIDTH/2; x++) left += merged.cell[y][x];
+    }
+
+    printf("%d games, %d telemetry files, %d threads, %.1f s\n", games, telemetryCount, histogramCount, elapsed/1000.0);
+    printf("%u shots: %u on buildings, %u on players, %u out of the field\n", impacts + merged.counts.out + merged.counts.beyond, merged.counts.building, merged.counts.player, merged.counts.out);
+    if (merged.counts.beyond > 0) printf("%u more on buildings or players beyond the %dx%d heatmap, left out of the counts and halves\n", merged.counts.beyond, FIELD_WIDTH, FIELD_HEIGHT);
+    if (impacts > 0) printf("left half %.1f%%, right half %.1f%% of the impacts\n", 100.0*left/impacts, 100.0*(impacts - left)/impacts);
+
+    if ((pngFile != NULL) && !ExportHeatmap(pngFile)) fprintf(stderr, "%s: failed to write\n", pngFile);
+    if ((rawFile != NULL) && !ExportRawHeatmap(rawFile)) fprintf(stderr, "%s: failed to write\n", rawFile);
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+// Bot tournament: many headless matches in flight at once against one external bot process per side.
+// Every match waiting for a shot has its turn in the pipe, so the bot answers back to back instead of one round trip per turn.
+// Usage: tournament "<bot command>" ["<opponent command>"] [--matches <n>] [--concurrent <n>] [--budget <ms>] [--seed <n>]
+// Without an opponent the same process plays both sides
+#define _POSIX_C_SOURCE 200809L
+
+#include "botprocess.h"
+#include "input.h"
+#include "match.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_CONCURRENT_MATCHES          256
+#define DEFAULT_MATCHES                1000
+#define DEFAULT_CONCURRENT               64
+#define DEFAULT_BUDGET                  500        // Milliseconds per turn
+#define RECEIVE_SHOTS                    64        // Answers read at once
+#define FIELD_WIDTH                     800
+#define FIELD_HEIGHT                    450
+
+typedef struct MatchSlot {
+    Match match;
+    bool active;
+    int side;                           // Bot process of the player whose turn it is
+    unsigned int turn;                  // Id of the turn in the pipe, 0 if it could not be sent
+    double deadline;
+    double sent;
+} MatchSlot;
+
+static MatchSlot slot[MAX_CONCURRENT_MATCHES] = { 0 };
+static BotProcess bot[2];
+static GameView view = { 0 };
+
+static int botCount = 1;
+static int budget = DEFAULT_BUDGET;
+static unsigned int seed = 1;
+
+static int startedMatches = 0;
+static int finishedMatches = 0;
+static int wins[2] = { 0 };
+static int draws = 0;
+static int turns = 0;
+static int fallbacks = 0;
+static double answerTime = 0.0;
+
+static double GetMilliseconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    return now.tv_sec*1000.0 + now.tv_nsec/1000000.0;
+}
+
+// Send the turn of the player to move, the budget starts now
+static void SendTurn(MatchSlot *match)
+{
+    match->side = (botCount > 1)? match->match.playerTurn%2 : 0;
+    GetMatchView(&match->match, &view);
+
+    match->sent = GetMilliseconds();
+    match->deadline = match->sent + budget;
+    match->turn = SendBotTurn(&bot[match->side], &view);
+}
+
+static void StartMatch(MatchSlot *match)
+{
+    Level level = { 0 };
+    GenerateLevel(&level, seed + startedMatches, FIELD_WIDTH, FIELD_HEIGHT);
+
+    InitMatch(&match->match, &level);
+    match->active = true;
+    startedMatches++;
+
+    SendTurn(match);
+}
+
+static void PlayTurn(MatchSlot *match, int angle, int power, bool answered)
+{
+    const Player *shooter = &match->match.player[match->match.playerTurn];
+
+    // Previous shot, or a default one, like the in-game bots
+    bool valid = answered && (angle >= 1) && (angle <= MAX_AIM_ANGLE) && (power >= 1) && (power <= MAX_AIM_POWER);
+
+    if (!valid)
+    {
+        bool previous = (shooter->previousAngle >= 1) && (shooter->previousPower >= 1);
+        angle = previous? shooter->previousAngle : 45;
+        power = previous? shooter->previousPower : 100;
+        fallbacks++;
+    }
+    else answerTime += GetMilliseconds() - match->sent;
+
+    PlayMatchShot(&match->match, angle, power);
+    turns++;
+
+    if (!match->match.over)
+    {
+        SendTurn(match);
+        return;
+    }
+
+    if (match->match.winner >= 0) wins[match->match.winner]++;
+    else draws++;
+
+    finishedMatches++;
+    match->active = false;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *command[2] = { NULL, NULL };
+    int matches = DEFAULT_MATCHES;
+    int concurrent = DEFAULT_CONCURRENT;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "--matches") == 0) && (i + 1 < argc)) matches = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--concurrent") == 0) && (i + 1 < argc)) concurrent = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--budget") == 0) && (i + 1 < argc)) budget = atoi(argv[++i]);
+        else if ((strcmp(argv[i], "--seed") == 0) && (i + 1 < argc)) seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+        else if (command[0] == NULL) command[0] = argv[i];
+        else if (command[1] == NULL) command[1] = argv[i];
+    }
+
+    if (command[0] == NULL)
+    {
+        fprintf(stderr, "Usage: %s \"<bot command>\" [\"<opponent command>\"] [--matches <n>] [--concurrent <n>] [--budget <ms>] [--seed <n>]\n", argv[0]);
+        return 1;
+    }
+
+    if (concurrent < 1) concurrent = 1;
+    if (concurrent > MAX_CONCURRENT_MATCHES) concurrent = MAX_CONCURRENT_MATCHES;
+    if (concurrent > matches) concurrent = (matches > 0)? matches : 1;
+
+    botCount = (command[1] != NULL)? 2 : 1;
+
+    for (int i = 0; i < botCount; i++)
+    {
+        if (!StartBotProcess(&bot[i], command[i])) return 1;
+    }
+
+    double start = GetMilliseconds();
+
+    for (int i = 0; (i < concurrent) && (startedMatches < matches); i++) StartMatch(&slot[i]);
+
+    while (finishedMatches < startedMatches)
+    {
+        // Wait on each bot up to the closest deadline, answers of every match arrive together
+        double now = GetMilliseconds();
+        double closest = now + budget;
+
+        for (int i = 0; i < concurrent; i++)
+        {
+            if (slot[i].active && (slot[i].deadline < closest)) closest = slot[i].deadline;
+        }
+
+        for (int b = 0; b < botCount; b++)
+        {
+            BotShot shot[RECEIVE_SHOTS];
+            // NOTE: Two bots share the wait, neither may hold back the answers of the other
+            int timeout = (int)(closest - now);
+            if ((botCount > 1) && (timeout > 1)) timeout = 1;
+            int count = ReceiveBotShots(&bot[b], shot, RECEIVE_SHOTS, (timeout > 0)? timeout : 0);
+
+            for (int s = 0; s < count; s++)
+            {
+                for (int i = 0; i < concurrent; i++)
+                {
+                    if (!slot[i].active || (slot[i].side != b) || (slot[i].turn != shot[s].id)) continue;
+
+                    PlayTurn(&slot[i], shot[s].angle, shot[s].power, true);
+                    if (!slot[i].active && (startedMatches < matches)) StartMatch(&slot[i]);
+                    break;
+                }
+            }
+        }
+
+        // Overruns, turns that could not be sent and dead bots get the fallback shot
+        now = GetMilliseconds();
+
+        for (int i = 0; i < concurrent; i++)
+        {
+            if (!slot[i].active) continue;
+
+            if ((slot[i].turn == 0) || bot[slot[i].side].failed || (now > slot[i].deadline))
+            {
+                PlayTurn(&slot[i], 0, 0, false);
+                if (!slot[i].active && (startedMatches < matches)) StartMatch(&slot[i]);
+            }
+        }
+    }
+
+    double elapsed = GetMilliseconds() - start;
+
+    for (int i = 0; i < botCount; i++) StopBotProcess(&bot[i]);
+
+    printf("%d matches, %d concurrent, %d turns in %.1f s (%.0f turns/s)\n", finishedMatches, concurrent, turns, elapsed/1000.0, 1000.0*turns/elapsed);
+    printf("left wins %d, right wins %d, draws %d\n", wins[0], wins[1], draws);
+    printf("fallback shots %d, average answer %.3f ms\n", fallbacks, (turns > fallbacks)? answerTime/(turns - fallbacks) : 0.0);
+
+    return 0;
+}